@@ -0,0 +1,22 @@
+#!/bin/bash
+
+BUILD_CMD="g++ -O2 -std=c++17 -pthread -o benchmark -Iinclude -Ibench -Ibench/bench_Huffman bench_main.cpp \
+bench/bench.cpp src/Point.cpp src/sampleFunc.cpp src/inventory.cpp bench/bench_Huffman/bench_case/*.cpp"
+# allocation counts replace the global operator new: a binary of their own
+BUILD_CMD="$BUILD_CMD && g++ -O2 -std=c++17 -pthread -o benchmark_alloc -Iinclude -Ibench bench_alloc_main.cpp \
+bench/bench.cpp src/Point.cpp src/sampleFunc.cpp src/inventory.cpp"
+
+echo "Building benchmarks with command:"
+echo "$BUILD_CMD"
+echo "----------------------------------------"
+eval $BUILD_CMD
+if [ $? -eq 0 ]; then
+    echo "Build successful!"
+    echo "----------------------------------------"
+    echo "1. Run all benchmarks: ./benchmark "
+    echo "2. Run a specific benchmark: ./benchmark benchName"
+    echo "3. Count tree allocations: ./benchmark_alloc"
+else
+    echo "Build failed!"
+    exit 1
+fi
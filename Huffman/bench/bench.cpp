@@ -0,0 +1,3 @@
+#include "bench.hpp"
+
+map<string, function<void()>> BENCH::BENCHES;
@@ -0,0 +1,95 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class BENCH
+{
+public:
+  BENCH() = default;
+  virtual ~BENCH() = default;
+
+  // Static map to store benchmark names and their corresponding functions
+  static map<string, function<void()>> BENCHES;
+
+  // Static method to register a benchmark
+  static void registerBench(const string &name,
+                            const function<void()> &function)
+  {
+    if (BENCHES.find(name) != BENCHES.end())
+    {
+      throw runtime_error("Benchmark with name '" + name + "' already exists.");
+    }
+    BENCHES[name] = function;
+  }
+
+  // ANSI escape codes for colors
+  inline static const string green = "\033[32m";
+  inline static const string cyan = "\033[36m";
+  inline static const string reset = "\033[0m"; // To reset to default color
+  inline static const string BOLD = "\033[1m";
+
+  // Wall-clock seconds taken by one call of work
+  static double timeIt(const function<void()> &work)
+  {
+    auto start = chrono::steady_clock::now();
+    work();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double>(stop - start).count();
+  }
+
+  // Best-of-N timing to damp scheduler noise
+  static double bestOf(int rounds, const function<void()> &work)
+  {
+    double best = 0;
+    for (int i = 0; i < rounds; ++i)
+    {
+      double t = timeIt(work);
+      if (i == 0 || t < best)
+        best = t;
+    }
+    return best;
+  }
+
+  // Print one aligned result row: label, value, unit
+  static void printRow(const string &label, double value, const string &unit)
+  {
+    cout << "  " << setw(40) << left << label << setw(16) << right
+         << fixed << setprecision(2) << value << " " << unit << "\n";
+  }
+
+  // Run a single benchmark
+  void runBench(const string &name)
+  {
+    auto it = BENCHES.find(name);
+    if (it == BENCHES.end())
+    {
+      throw runtime_error("Benchmark with name '" + name + "' does not exist.");
+    }
+    cout << cyan << BOLD << "Bench " << name << reset << "\n";
+    it->second();
+  }
+
+  // Run all benchmarks
+  void runAllBenches()
+  {
+    for (const auto &[name, bench] : BENCHES)
+    {
+      runBench(name);
+      cout << "\n";
+    }
+    cout << green << BOLD << "All benchmarks finished." << reset << endl;
+  }
+};
+
+#endif // BENCH_HPP
@@ -0,0 +1,96 @@
+#ifndef BENCH_Huffman_HPP
+#define BENCH_Huffman_HPP
+
+#include "app/inventory_compressor.h"
+#include "app/columnar_compressor.h"
+#include "app/tree_order.h"
+#include "hash/SwissMap.h"
+#include "hash/ConcurrentXMap.h"
+#include "bench.hpp"
+
+// Macro to simplify benchmark registration
+#define REGISTER_BENCH(func) registerBench(#func, [this]() { func(); })
+
+class BENCH_Huffman : public BENCH
+{
+public:
+  BENCH_Huffman()
+  {
+    REGISTER_BENCH(DecodeTable);
+    REGISTER_BENCH(TwoQueueBuild);
+    REGISTER_BENCH(LengthLimit);
+    REGISTER_BENCH(FrequencyCount);
+    REGISTER_BENCH(EncodeTable);
+    REGISTER_BENCH(BatchEncode);
+    REGISTER_BENCH(ParallelScaling);
+    REGISTER_BENCH(ParallelDecode);
+    REGISTER_BENCH(BinarySerializer);
+    REGISTER_BENCH(ColumnarCompression);
+    REGISTER_BENCH(ColumnProjection);
+    REGISTER_BENCH(TextParse);
+    REGISTER_BENCH(AdaptiveStream);
+    REGISTER_BENCH(IncrementalCodebook);
+    REGISTER_BENCH(OrderSelection);
+    REGISTER_BENCH(DecodeKernels);
+    REGISTER_BENCH(DigitTranslate);
+    REGISTER_BENCH(MapProbing);
+    REGISTER_BENCH(RehashLatency);
+    REGISTER_BENCH(PoolAllocation);
+    REGISTER_BENCH(ConcurrentLookups);
+    REGISTER_BENCH(StringLookups);
+  }
+
+private:
+  void DecodeTable();
+  void TwoQueueBuild();
+  void LengthLimit();
+  void FrequencyCount();
+  void EncodeTable();
+  void BatchEncode();
+  void ParallelScaling();
+  void ParallelDecode();
+  void BinarySerializer();
+  void ColumnarCompression();
+  void ColumnProjection();
+  void TextParse();
+  void AdaptiveStream();
+  void IncrementalCodebook();
+  void OrderSelection();
+  void DecodeKernels();
+  void DigitTranslate();
+  void MapProbing();
+  void RehashLatency();
+  void PoolAllocation();
+  void ConcurrentLookups();
+  void StringLookups();
+};
+
+/*
+ * makeInventory(products, seed):
+ *  deterministic synthetic warehouse: a handful of product families with
+ *  repeating attribute names and pseudo-random values
+ */
+inline InventoryManager makeInventory(int products, unsigned int seed = 2024)
+{
+  static const char *families[] = {"Fan", "Battery", "Laptop", "Aircon", "Fridge", "Lamp"};
+  static const char *attrNames[] = {"power", "noise", "weight", "voltage", "speed", "capacity", "rpm", "temp_range"};
+
+  InventoryManager manager;
+  for (int i = 0; i < products; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    int family = (seed >> 16) % 6;
+    List1D<InventoryAttribute> attrs;
+    int attrCount = 2 + (seed >> 8) % 4;
+    for (int a = 0; a < attrCount; ++a)
+    {
+      seed = seed * 1103515245u + 12345u;
+      double value = ((seed >> 12) % 100000) / 100.0;
+      attrs.add(InventoryAttribute(attrNames[(family + a) % 8], value));
+    }
+    manager.addProduct(attrs, string(families[family]) + "_" + to_string(i % 997), 1 + i % 50);
+  }
+  return manager;
+}
+
+#endif // BENCH_Huffman_HPP
@@ -0,0 +1,57 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * One-pass adaptive coding of a 200k-product feed against the two-pass
+ * static code (buildHuffman over the whole inventory, then encodeAll):
+ * compressed size and products/s. The static size includes its codebook.
+ */
+template <int treeOrder>
+static void adaptiveFor(InventoryManager &inventory)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    double products = inventory.size();
+    string prefix = "order " + to_string(treeOrder);
+
+    InventoryCompressor<treeOrder> twoPass(&inventory);
+    HuffmanBatch batch;
+    double staticTime = BENCH::timeIt([&]() {
+        twoPass.buildHuffman(true);
+        twoPass.encodeAll(batch);
+    });
+    double staticBytes = batch.data.size() + twoPass.codebookHeader().size();
+
+    InventoryManager nothing;
+    InventoryCompressor<treeOrder> writer(&nothing);
+    InventoryCompressor<treeOrder> reader(&nothing);
+    List1D<string> codes;
+    double adaptiveDigits = 0;
+    double encode = BENCH::timeIt([&]() {
+        for (int i = 0; i < inventory.size(); ++i)
+            codes.add(writer.encodeAdaptive(inventory.getProductAttributes(i), inventory.getProductName(i)));
+    });
+    for (int i = 0; i < codes.size(); ++i)
+        adaptiveDigits += codes.at(i).length();
+    int clean = 0;
+    double decode = BENCH::timeIt([&]() {
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        for (int i = 0; i < codes.size(); ++i)
+            clean += reader.decodeAdaptive(codes.at(i), attributesOutput, nameOutput) != "\\x00";
+    });
+
+    BENCH::printRow(prefix + " static size", staticBytes / products, "bytes/product");
+    BENCH::printRow(prefix + " adaptive size", adaptiveDigits * digitBits / 8 / products, "bytes/product");
+    BENCH::printRow(prefix + " static build+encode", products / staticTime / 1e3, "k products/s");
+    BENCH::printRow(prefix + " adaptive encode", products / encode / 1e3, "k products/s");
+    BENCH::printRow(prefix + " adaptive decode", products / decode / 1e3, "k products/s");
+    if (clean != inventory.size())
+        BENCH::printRow(prefix + " FAILED decodes", inventory.size() - clean, "");
+}
+
+void BENCH_Huffman::AdaptiveStream()
+{
+    InventoryManager inventory = makeInventory(200000);
+    adaptiveFor<2>(inventory);
+    adaptiveFor<4>(inventory);
+    adaptiveFor<16>(inventory);
+}
@@ -0,0 +1,53 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Whole-inventory round trip, 200k products: the caller-side loop over
+ * getProductAttributes / encodeHuffman / decodeHuffman (collecting rows and
+ * names the same way) against encodeAll / decodeAll over one contiguous
+ * buffer.
+ */
+void BENCH_Huffman::BatchEncode()
+{
+    InventoryManager inventory = makeInventory(200000);
+    InventoryCompressor<4> compressor(&inventory);
+    compressor.buildHuffman();
+
+    size_t loopDigits = 0;
+    XArrayList<string> codes;
+    double loopEncode = BENCH::timeIt([&]() {
+        for (int i = 0; i < inventory.size(); ++i)
+        {
+            codes.add(compressor.encodeHuffman(inventory.getProductAttributes(i), inventory.getProductName(i)));
+            loopDigits += codes.get(i).length();
+        }
+    });
+    double loopDecode = BENCH::timeIt([&]() {
+        List2D<InventoryAttribute> rows;
+        List1D<string> names;
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        for (int i = 0; i < codes.size(); ++i)
+        {
+            compressor.decodeHuffman(codes.get(i), attributesOutput, nameOutput);
+            rows.setRow(rows.rows(), attributesOutput);
+            names.add(nameOutput);
+        }
+    });
+
+    HuffmanBatch batch;
+    double batchEncode = BENCH::bestOf(3, [&]() { compressor.encodeAll(batch); });
+    int clean = 0;
+    double batchDecode = BENCH::timeIt([&]() {
+        List2D<InventoryAttribute> attributesOutput;
+        List1D<string> namesOutput;
+        clean = compressor.decodeAll(batch, attributesOutput, namesOutput);
+    });
+
+    BENCH::printRow("per-product encode loop", loopEncode * 1e3, "ms");
+    BENCH::printRow("encodeAll", batchEncode * 1e3, "ms");
+    BENCH::printRow("per-product decode loop", loopDecode * 1e3, "ms");
+    BENCH::printRow("decodeAll", batchDecode * 1e3, "ms");
+    BENCH::printRow("digit strings (loop)", loopDigits / 1048576.0, "MiB");
+    BENCH::printRow("packed batch", batch.data.size() / 1048576.0, "MiB");
+    BENCH::printRow("products decoded cleanly", clean, "");
+}
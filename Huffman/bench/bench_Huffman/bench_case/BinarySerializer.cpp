@@ -0,0 +1,46 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Text vs. binary product serialization, end to end on 200k products:
+ * serialized and Huffman-coded bytes per product, encodeAll / decodeAll
+ * throughput.
+ */
+template <int treeOrder>
+static void serializerFor(InventoryManager &inventory, SerializationMode mode, const string &label)
+{
+    InventoryCompressor<treeOrder> compressor(&inventory);
+    compressor.setSerializationMode(mode);
+    double build = BENCH::timeIt([&]() { compressor.buildHuffman(); });
+
+    double raw = 0;
+    for (int i = 0; i < inventory.size(); ++i)
+        raw += compressor.serializeProduct(inventory.getProductAttributes(i), inventory.getProductName(i)).length();
+
+    HuffmanBatch batch;
+    double encode = BENCH::bestOf(3, [&]() { compressor.encodeAll(batch); });
+    int clean = 0;
+    double decode = BENCH::timeIt([&]() {
+        List2D<InventoryAttribute> rows;
+        List1D<string> names;
+        clean = compressor.decodeAll(batch, rows, names);
+    });
+
+    double products = inventory.size();
+    string prefix = "order " + to_string(treeOrder) + " " + label;
+    BENCH::printRow(prefix + " serialized", raw / products, "bytes/product");
+    BENCH::printRow(prefix + " compressed", batch.data.size() / products, "bytes/product");
+    BENCH::printRow(prefix + " buildHuffman", build * 1e3, "ms");
+    BENCH::printRow(prefix + " encodeAll", products / encode / 1e3, "k products/s");
+    BENCH::printRow(prefix + " decodeAll", products / decode / 1e3, "k products/s");
+    if (clean != inventory.size())
+        BENCH::printRow(prefix + " FAILED round trips", inventory.size() - clean, "");
+}
+
+void BENCH_Huffman::BinarySerializer()
+{
+    InventoryManager inventory = makeInventory(200000);
+    serializerFor<4>(inventory, TEXT_SERIALIZATION, "text");
+    serializerFor<4>(inventory, BINARY_SERIALIZATION, "binary");
+    serializerFor<16>(inventory, TEXT_SERIALIZATION, "text");
+    serializerFor<16>(inventory, BINARY_SERIALIZATION, "binary");
+}
@@ -0,0 +1,27 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Projection reads of a 200k-product columnar archive: full decompress vs.
+ * one attribute, quantities only, and one attribute with names.
+ */
+void BENCH_Huffman::ColumnProjection()
+{
+    InventoryManager inventory = makeInventory(200000);
+    ColumnarCompressor<4> columnar(&inventory);
+    string archive = columnar.compress();
+    double products = inventory.size();
+
+    double full = BENCH::bestOf(3, [&]() { columnar.decompress(archive); });
+    BENCH::printRow("full decompress", products / full / 1e3, "k products/s");
+
+    List1D<string> power;
+    power.add("power");
+    List1D<string> none;
+    double powerOnly = BENCH::bestOf(3, [&]() { columnar.decompress(archive, power); });
+    double quantities = BENCH::bestOf(3, [&]() { columnar.decompress(archive, none, false, true); });
+    double powerNames = BENCH::bestOf(3, [&]() { columnar.decompress(archive, power, true); });
+    BENCH::printRow("power only", products / powerOnly / 1e3, "k products/s");
+    BENCH::printRow("quantities only", products / quantities / 1e3, "k products/s");
+    BENCH::printRow("power + names", products / powerNames / 1e3, "k products/s");
+    BENCH::printRow("power only speedup", full / powerOnly, "x");
+}
@@ -0,0 +1,53 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Row-wise (binary records, one shared code) vs. columnar (one code per
+ * column) on 200k products: archive bytes per product, compress and
+ * decompress throughput.
+ */
+template <int treeOrder>
+static void columnarFor(InventoryManager &inventory)
+{
+    double products = inventory.size();
+    string prefix = "order " + to_string(treeOrder);
+
+    InventoryCompressor<treeOrder> rows(&inventory);
+    rows.setSerializationMode(BINARY_SERIALIZATION);
+    string container;
+    double rowEncode = BENCH::timeIt([&]() {
+        rows.buildHuffman(true);
+        container = rows.encodeContainer();
+    });
+    double rowBytes = container.size() + rows.codebookHeader().size() + rows.attributeDictionary().size();
+    double rowDecode = BENCH::timeIt([&]() {
+        List2D<InventoryAttribute> decoded;
+        List1D<string> names;
+        rows.decodeContainer(container, decoded, names);
+    });
+
+    ColumnarCompressor<treeOrder> columnar(&inventory);
+    string archive;
+    double columnEncode = BENCH::timeIt([&]() { archive = columnar.compress(); });
+    bool same = true;
+    double columnDecode = BENCH::timeIt([&]() {
+        InventoryManager restored = columnar.decompress(archive);
+        same = restored.size() == inventory.size();
+    });
+
+    BENCH::printRow(prefix + " row-wise archive", rowBytes / products, "bytes/product");
+    BENCH::printRow(prefix + " columnar archive", archive.size() / products, "bytes/product");
+    BENCH::printRow(prefix + " row-wise build+encode", products / rowEncode / 1e3, "k products/s");
+    BENCH::printRow(prefix + " columnar compress", products / columnEncode / 1e3, "k products/s");
+    BENCH::printRow(prefix + " row-wise decode", products / rowDecode / 1e3, "k products/s");
+    BENCH::printRow(prefix + " columnar decompress", products / columnDecode / 1e3, "k products/s");
+    if (!same)
+        BENCH::printRow(prefix + " FAILED round trip", 0, "");
+}
+
+void BENCH_Huffman::ColumnarCompression()
+{
+    InventoryManager inventory = makeInventory(200000);
+    columnarFor<2>(inventory);
+    columnarFor<4>(inventory);
+    columnarFor<16>(inventory);
+}
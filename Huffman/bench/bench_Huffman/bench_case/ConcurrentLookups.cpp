@@ -0,0 +1,67 @@
+#include "../bench_Huffman.hpp"
+#include <mutex>
+#include <thread>
+
+/*
+ * Product lookups from 1 to 64 threads: 90% get / 10% put over 256K keys,
+ * 2M operations in total split across the threads. ConcurrentXMap with 64
+ * shards vs. one xMap behind a single global mutex (what ingest does today).
+ * Throughput only scales with the cores the machine has; past that the
+ * figure shows what the locking costs.
+ */
+static int contentionHash(int &key, int size) { return key % size; }
+
+static int contentionKey(unsigned int &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (int)((seed >> 8) & (256 * 1024 - 1));
+}
+
+template <class Operation>
+static double runThreads(int threads, int operations, Operation operation)
+{
+    return BENCH::timeIt([&]() {
+        thread *workers = new thread[threads];
+        for (int t = 0; t < threads; ++t) {
+            workers[t] = thread([&, t]() {
+                unsigned int seed = 17 + t;
+                for (int i = 0; i < operations / threads; ++i) operation(seed);
+            });
+        }
+        for (int t = 0; t < threads; ++t) workers[t].join();
+        delete[] workers;
+    });
+}
+
+void BENCH_Huffman::ConcurrentLookups()
+{
+    const int keys = 256 * 1024, operations = 2000000;
+
+    ConcurrentXMap<int, int> sharded(&contentionHash, 64);
+    xMap<int, int> global(&contentionHash);
+    mutex globalLock;
+    for (int key = 0; key < keys; ++key) {
+        sharded.put(key, key);
+        global.put(key, key);
+    }
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double seconds = runThreads(threads, operations, [&](unsigned int &seed) {
+            int key = contentionKey(seed);
+            if (seed % 10 == 0) sharded.put(key, (int)seed);
+            else {
+                int value;
+                sharded.tryGet(key, value);
+            }
+        });
+        BENCH::printRow("sharded, " + to_string(threads) + " threads", operations / seconds / 1e6, "Mops/s");
+
+        seconds = runThreads(threads, operations, [&](unsigned int &seed) {
+            int key = contentionKey(seed);
+            lock_guard<mutex> guard(globalLock);
+            if (seed % 10 == 0) global.put(key, (int)seed);
+            else if (global.containsKey(key)) global.get(key);
+        });
+        BENCH::printRow("global mutex, " + to_string(threads) + " threads", operations / seconds / 1e6, "Mops/s");
+    }
+}
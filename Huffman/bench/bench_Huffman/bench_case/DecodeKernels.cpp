@@ -0,0 +1,71 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Specialised (power-of-two treeOrder) decode kernels vs. the generic ones,
+ * on the encoded text of a synthetic inventory, as digit text and bit-packed.
+ */
+template <int treeOrder>
+static void decodeKernelsFor(const string &text)
+{
+    XArrayList<pair<char, int>> freqList;
+    int counts[256] = {0};
+    for (char c : text) counts[(unsigned char)c]++;
+    for (int c = 0; c < 256; ++c)
+        if (counts[c] > 0) freqList.add({(char)c, counts[c]});
+
+    HuffmanTree<treeOrder> tree;
+    tree.build(freqList);
+    xMap<char, string> table([](char &key, int size) { return (int)(unsigned char)key % size; });
+    tree.generateCodes(table);
+
+    string code;
+    for (char c : text) code += table.get(c);
+
+    const int bits = HuffmanTree<treeOrder>::bitsPerDigit;
+    long long bitCount = (long long)code.size() * bits;
+    string packed((size_t)(bitCount + 7) / 8, '\0');
+    for (size_t i = 0; i < code.size(); ++i) {
+        int digit = code[i] <= '9' ? code[i] - '0' : code[i] - 'a' + 10;
+        for (int b = 0; b < bits; ++b) {
+            long long bit = (long long)i * bits + b;
+            if (digit >> (bits - 1 - b) & 1) packed[bit >> 3] |= (char)(0x80 >> (bit & 7));
+        }
+    }
+    const unsigned char *data = (const unsigned char *)packed.data();
+
+    tree.prepareDecode();
+    string generic, special, genericPacked, specialPacked;
+    double textGeneric = BENCH::bestOf(3, [&]() { generic = tree.decodeGeneric(code); });
+    double textSpecial = BENCH::bestOf(3, [&]() { special = tree.decode(code); });
+    double packGeneric = BENCH::bestOf(3, [&]() {
+        genericPacked.clear();
+        tree.decodePackedGeneric(data, 0, bitCount, genericPacked);
+    });
+    double packSpecial = BENCH::bestOf(3, [&]() {
+        specialPacked.clear();
+        tree.decodePacked(data, 0, bitCount, specialPacked);
+    });
+    if (generic != text || special != text || genericPacked != text || specialPacked != text)
+        cout << "  order " << treeOrder << ": MISMATCH\n";
+
+    double symbols = (double)text.size();
+    string label = "order " + to_string(treeOrder);
+    BENCH::printRow(label + " text, generic", symbols / textGeneric / 1e6, "Msym/s");
+    BENCH::printRow(label + " text, specialised", symbols / textSpecial / 1e6, "Msym/s");
+    BENCH::printRow(label + " packed, generic", symbols / packGeneric / 1e6, "Msym/s");
+    BENCH::printRow(label + " packed, specialised", symbols / packSpecial / 1e6, "Msym/s");
+}
+
+void BENCH_Huffman::DecodeKernels()
+{
+    InventoryManager manager = makeInventory(20000);
+    InventoryCompressor<2> formatter(&manager);
+    string text;
+    for (int i = 0; i < manager.size(); ++i)
+        text += formatter.productToString(manager.getProductAttributes(i), manager.getProductName(i));
+
+    decodeKernelsFor<2>(text);
+    decodeKernelsFor<4>(text);
+    decodeKernelsFor<8>(text);
+    decodeKernelsFor<16>(text);
+}
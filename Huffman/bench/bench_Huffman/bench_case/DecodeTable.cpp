@@ -0,0 +1,50 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Table-driven decode vs. the one-digit-per-step tree walk on the encoded
+ * text of a synthetic inventory.
+ */
+template <int treeOrder>
+static void decodeTableFor(const string &text)
+{
+
+    XArrayList<pair<char, int>> freqList;
+    int counts[256] = {0};
+    for (char c : text) counts[(unsigned char)c]++;
+    for (int c = 0; c < 256; ++c)
+        if (counts[c] > 0) freqList.add({(char)c, counts[c]});
+
+    HuffmanTree<treeOrder> tree;
+    tree.build(freqList);
+    xMap<char, string> table([](char &key, int size) { return (int)(unsigned char)key % size; });
+    tree.generateCodes(table);
+
+    string code;
+    for (char c : text) code += table.get(c);
+
+    string walked, tabled;
+    double walk = BENCH::bestOf(3, [&]() { walked = tree.decodeTreeWalk(code); });
+    tree.decode("0");   // build the table outside the timed region
+    double lookup = BENCH::bestOf(3, [&]() { tabled = tree.decode(code); });
+    if (walked != text || tabled != text)
+        cout << "  order " << treeOrder << ": MISMATCH\n";
+
+    double symbols = (double)text.size();
+    BENCH::printRow("order " + to_string(treeOrder) + " tree walk", symbols / walk / 1e6, "Msym/s");
+    BENCH::printRow("order " + to_string(treeOrder) + " table (" + to_string(HuffmanTree<treeOrder>::decodeChunk) + " digits/lookup)",
+                    symbols / lookup / 1e6, "Msym/s");
+}
+
+void BENCH_Huffman::DecodeTable()
+{
+    InventoryManager manager = makeInventory(20000);
+    InventoryCompressor<2> formatter(&manager);
+    string text;
+    for (int i = 0; i < manager.size(); ++i)
+        text += formatter.productToString(manager.getProductAttributes(i), manager.getProductName(i));
+
+    decodeTableFor<2>(text);
+    decodeTableFor<4>(text);
+    decodeTableFor<8>(text);
+    decodeTableFor<16>(text);
+}
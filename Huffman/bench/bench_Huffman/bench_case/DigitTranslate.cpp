@@ -0,0 +1,50 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Validation + translation of textual code digits (translateDigits): scalar
+ * table vs. SSE2 vs. AVX2 kernels, in GB of digit text per second.
+ */
+typedef bool (*DigitKernel)(const char *, size_t, int, unsigned char *);
+
+static void translateRow(const string &label, DigitKernel kernel, const string &code, int base, unsigned char *values)
+{
+    bool ok = false;
+    double seconds = BENCH::bestOf(5, [&]() { ok = kernel(code.data(), code.size(), base, values); });
+    if (!ok) cout << "  " << label << ": REJECTED\n";
+    BENCH::printRow(label, (double)code.size() / seconds / 1e9, "GB/s");
+}
+
+void BENCH_Huffman::DigitTranslate()
+{
+    InventoryManager manager = makeInventory(20000);
+    InventoryCompressor<16> compressor(&manager);
+    compressor.buildHuffman();
+    string code;
+    for (int i = 0; i < manager.size(); ++i)
+        code += compressor.encodeHuffman(manager.getProductAttributes(i), manager.getProductName(i));
+    unsigned char *values = new unsigned char[code.size()];
+
+    // whole code string, as one pre-pass
+    translateRow("scalar table", translateDigitsScalar, code, 16, values);
+#ifdef DIGITTRANSLATE_SSE2
+    translateRow("SSE2 (16 digits/step)", translateDigitsSSE2, code, 16, values);
+#endif
+#ifdef DIGITTRANSLATE_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        translateRow("AVX2 (32 digits/step)", translateDigitsAVX2, code, 16, values);
+#endif
+
+    // the block size decode translates at a time (order 16: 2 * 1024 digits)
+    string block = code.substr(0, 2048);
+    double scalar = BENCH::bestOf(5, [&]() {
+        for (size_t i = 0; i + block.size() <= code.size(); i += block.size())
+            translateDigitsScalar(code.data() + i, block.size(), 16, values);
+    });
+    double best = BENCH::bestOf(5, [&]() {
+        for (size_t i = 0; i + block.size() <= code.size(); i += block.size())
+            translateDigits(code.data() + i, block.size(), 16, values);
+    });
+    BENCH::printRow("2 KiB blocks, scalar", (double)code.size() / scalar / 1e9, "GB/s");
+    BENCH::printRow("2 KiB blocks, translateDigits", (double)code.size() / best / 1e9, "GB/s");
+    delete[] values;
+}
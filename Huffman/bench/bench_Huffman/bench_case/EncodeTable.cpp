@@ -0,0 +1,86 @@
+#include "../bench_Huffman.hpp"
+
+static int encodeCharHash(char &key, int tableSize)
+{
+    return static_cast<int>(key) % tableSize;
+}
+
+/*
+ * Encoding 200k products: the former per-symbol xMap<char,string>
+ * containsKey/get + string append, against the flat CodeEntry table
+ * (digit-string and bit-packed outputs).
+ */
+template <int treeOrder>
+static void encodeTableFor(InventoryManager &inventory, XArrayList<pair<char, int>> &freqs)
+{
+    InventoryCompressor<treeOrder> compressor(&inventory);
+    compressor.buildHuffman();
+
+    HuffmanTree<treeOrder> tree;
+    tree.buildTwoQueue(freqs);
+    xMap<char, string> codes(&encodeCharHash);
+    tree.generateCodes(codes);
+
+    XArrayList<string> texts;
+    for (int i = 0; i < inventory.size(); ++i)
+        texts.add(compressor.productToString(inventory.getProductAttributes(i), inventory.getProductName(i)));
+
+    size_t digits = 0;
+    double mapTime = BENCH::bestOf(3, [&]() {
+        digits = 0;
+        for (int i = 0; i < texts.size(); ++i)
+        {
+            string code;
+            for (char c : texts.get(i))
+            {
+                if (!codes.containsKey(c))
+                    throw runtime_error("missing");
+                code += codes.get(c);
+            }
+            digits += code.length();
+        }
+    });
+
+    List1D<InventoryAttribute> *attrs = new List1D<InventoryAttribute>[inventory.size()];
+    for (int i = 0; i < inventory.size(); ++i)
+        attrs[i] = inventory.getProductAttributes(i);
+
+    // productToString runs inside encodeHuffman; time it alone to isolate the lookup cost
+    double textTime = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < inventory.size(); ++i)
+            compressor.productToString(attrs[i], inventory.getProductNameRef(i));
+    });
+    double stringTime = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < inventory.size(); ++i)
+            compressor.encodeHuffman(attrs[i], inventory.getProductNameRef(i));
+    });
+    unsigned char buffer[4096];
+    double packedTime = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < inventory.size(); ++i)
+            compressor.encodeHuffman(attrs[i], inventory.getProductNameRef(i), buffer, sizeof(buffer));
+    });
+    delete[] attrs;
+
+    double symbols = 0;
+    for (int i = 0; i < texts.size(); ++i)
+        symbols += texts.get(i).length();
+
+    string label = "order " + to_string(treeOrder);
+    BENCH::printRow(label + " xMap lookups", mapTime / symbols * 1e9, "ns/symbol");
+    BENCH::printRow(label + " flat table, digit string", (stringTime - textTime) / symbols * 1e9, "ns/symbol");
+    BENCH::printRow(label + " flat table, bit-packed", (packedTime - textTime) / symbols * 1e9, "ns/symbol");
+}
+
+void BENCH_Huffman::EncodeTable()
+{
+    InventoryManager inventory = makeInventory(200000);
+    InventoryCompressor<2> counter(&inventory);
+    CharHistogram<4> histogram;
+    counter.countFrequencies(histogram);
+    XArrayList<pair<char, int>> freqs;
+    histogram.toFreqList(freqs);
+
+    encodeTableFor<2>(inventory, freqs);
+    encodeTableFor<4>(inventory, freqs);
+    encodeTableFor<16>(inventory, freqs);
+}
@@ -0,0 +1,56 @@
+#include "../bench_Huffman.hpp"
+
+static int benchCharHash(char &key, int tableSize)
+{
+    return static_cast<int>(key) % tableSize;
+}
+
+/*
+ * Frequency collection over a 1M-product inventory: the former buildHuffman
+ * loop (copied attributes, ostringstream per product, xMap<char,int>
+ * containsKey/get/put per character) against the streamed CharHistogram.
+ */
+void BENCH_Huffman::FrequencyCount()
+{
+    const int products = 1000000;
+    InventoryManager inventory = makeInventory(products);
+    InventoryCompressor<4> compressor(&inventory);
+
+    unsigned long long characters = 0;
+    double mapTime = BENCH::timeIt([&]() {
+        xMap<char, int> freqMap(&benchCharHash);
+        for (int i = 0; i < inventory.size(); ++i)
+        {
+            List1D<InventoryAttribute> attributes = inventory.getProductAttributes(i);
+            std::ostringstream result;
+            result << inventory.getProductName(i) << ":";
+            for (int a = 0; a < attributes.size(); ++a)
+            {
+                const InventoryAttribute &attr = attributes.get(a);
+                result << "(" << attr.name << ": " << std::fixed << std::setprecision(6) << attr.value << ")";
+                if (a < attributes.size() - 1)
+                    result << ", ";
+            }
+            for (char c : result.str())
+            {
+                int count = freqMap.containsKey(c) ? freqMap.get(c) + 1 : 1;
+                freqMap.put(c, count);
+                characters++;
+            }
+        }
+    });
+
+    double laneTime[3];
+    laneTime[0] = BENCH::bestOf(3, [&]() { CharHistogram<1> h; compressor.countFrequencies(h); });
+    laneTime[1] = BENCH::bestOf(3, [&]() { CharHistogram<4> h; compressor.countFrequencies(h); });
+    laneTime[2] = BENCH::bestOf(3, [&]() { CharHistogram<8> h; compressor.countFrequencies(h); });
+    double buildTime = BENCH::bestOf(3, [&]() { compressor.buildHuffman(); });
+
+    BENCH::printRow("characters counted", characters / 1e6, "M");
+    BENCH::printRow("xMap<char,int> + ostringstream", mapTime * 1e3, "ms");
+    BENCH::printRow("CharHistogram<1>", laneTime[0] * 1e3, "ms");
+    BENCH::printRow("CharHistogram<4>", laneTime[1] * 1e3, "ms");
+    BENCH::printRow("CharHistogram<8>", laneTime[2] * 1e3, "ms");
+    BENCH::printRow("speedup (4 lanes)", mapTime / laneTime[1], "x");
+    BENCH::printRow("buildHuffman() total", buildTime * 1e3, "ms");
+}
@@ -0,0 +1,55 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Keeping the code current over 20k add/remove mutations of a 200k-product
+ * inventory: live histogram deltas with threshold rebuilds, against a full
+ * buildHuffman after every mutation (timed on the first 20 and scaled).
+ */
+void BENCH_Huffman::IncrementalCodebook()
+{
+    const int mutations = 20000;
+    InventoryManager inventory = makeInventory(200000);
+    InventoryManager incoming = makeInventory(mutations, 77);
+
+    InventoryManager liveCopy(inventory);
+    InventoryCompressor<4> live(&liveCopy);
+    live.buildHuffman(true);
+    int before = live.codebookVersion();
+    double liveTime = BENCH::timeIt([&]() {
+        for (int i = 0; i < mutations; ++i)
+        {
+            live.addProduct(incoming.getProductAttributes(i), incoming.getProductName(i), incoming.getProductQuantity(i));
+            live.removeProduct(i % 1000);
+        }
+    });
+
+    // the manager's own share: removing from the front shifts the row arrays
+    InventoryManager bareCopy(inventory);
+    double bareTime = BENCH::timeIt([&]() {
+        for (int i = 0; i < mutations; ++i)
+        {
+            bareCopy.addProduct(incoming.getProductAttributes(i), incoming.getProductName(i), incoming.getProductQuantity(i));
+            bareCopy.removeProduct(i % 1000);
+        }
+    });
+
+    const int sampled = 20;
+    InventoryManager fullCopy(inventory);
+    InventoryCompressor<4> full(&fullCopy);
+    double fullTime = BENCH::timeIt([&]() {
+        for (int i = 0; i < sampled; ++i)
+        {
+            fullCopy.addProduct(incoming.getProductAttributes(i), incoming.getProductName(i), incoming.getProductQuantity(i));
+            full.buildHuffman(true);
+            fullCopy.removeProduct(i % 1000);
+            full.buildHuffman(true);
+        }
+    }) / (2 * sampled);
+
+    BENCH::printRow("live histogram", liveTime / (2 * mutations) * 1e6, "us/mutation");
+    BENCH::printRow("  of which the manager", bareTime / (2 * mutations) * 1e6, "us/mutation");
+    BENCH::printRow("full buildHuffman", fullTime * 1e6, "us/mutation");
+    BENCH::printRow("speedup", fullTime / (liveTime / (2 * mutations)), "x");
+    BENCH::printRow("threshold rebuilds", live.codebookVersion() - before, "");
+    BENCH::printRow("final inefficiency", live.estimatedInefficiency() * 100, "%");
+}
@@ -0,0 +1,64 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Compression-ratio cost of capping code lengths, on a heavily skewed
+ * 256-symbol alphabet (geometric-like weights) where plain Huffman codes
+ * get very deep.
+ */
+template <int treeOrder>
+static void lengthLimitFor(XArrayList<pair<char, int>> &freqs, int limit)
+{
+    HuffmanTree<treeOrder> tree;
+    double seconds;
+    if (limit > 0)
+        seconds = BENCH::timeIt([&]() { tree.buildLengthLimited(freqs, limit); });
+    else
+        seconds = BENCH::timeIt([&]() { tree.build(freqs); });
+
+    XArrayList<pair<char, int>> lengths;
+    tree.codeLengths(lengths);
+    int symbolLength[256] = {0};
+    int longest = 0;
+    for (int i = 0; i < lengths.size(); ++i)
+    {
+        symbolLength[(unsigned char)lengths.get(i).first] = lengths.get(i).second;
+        if (lengths.get(i).second > longest)
+            longest = lengths.get(i).second;
+    }
+    double digits = 0;
+    for (int i = 0; i < freqs.size(); ++i)
+        digits += (double)freqs.get(i).second * symbolLength[(unsigned char)freqs.get(i).first];
+
+    static double unconstrainedBits = 0;
+    double bits = digits * HuffmanTree<treeOrder>::bitsPerDigit;
+    if (limit == 0)
+        unconstrainedBits = bits;
+
+    string label = "order " + to_string(treeOrder) + (limit ? " limit " + to_string(limit) : " unlimited");
+    BENCH::printRow(label + " longest code", longest, "digits");
+    BENCH::printRow(label + " encoded size", bits / 8 / 1024, "KiB");
+    if (limit > 0)
+        BENCH::printRow(label + " ratio loss", (bits / unconstrainedBits - 1) * 100, "%");
+    BENCH::printRow(label + " build", seconds * 1e6, "us");
+}
+
+void BENCH_Huffman::LengthLimit()
+{
+    XArrayList<pair<char, int>> freqs;
+    double weight = 1e6;
+    for (int c = 0; c < 256; ++c)
+    {
+        freqs.add({(char)c, 1 + (int)weight});
+        weight *= 0.93;
+    }
+
+    lengthLimitFor<2>(freqs, 0);
+    lengthLimitFor<2>(freqs, 15);
+    lengthLimitFor<2>(freqs, 12);
+    lengthLimitFor<4>(freqs, 0);
+    lengthLimitFor<4>(freqs, 12);
+    lengthLimitFor<4>(freqs, 8);
+    lengthLimitFor<16>(freqs, 0);
+    lengthLimitFor<16>(freqs, 4);
+    lengthLimitFor<16>(freqs, 3);
+}
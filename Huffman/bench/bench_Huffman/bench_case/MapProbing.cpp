@@ -0,0 +1,97 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * SwissMap (open addressing, 16-wide control-byte probes) vs. xMap (chained
+ * buckets): insert / hit / miss / erase throughput at several load factors.
+ * SwissMap is held at a fixed 2^18 slots and filled to each load; xMap is
+ * given the same loadFactor and grows to it by itself.
+ */
+static const int swissSlots = 1 << 18;
+
+static int intHash(int &key, int size) { return key % size; }
+
+static int fnvHash(string &key, int size)
+{
+    unsigned int hash = 2166136261u;
+    for (char c : key) hash = (hash ^ (unsigned char)c) * 16777619u;
+    return (int)(hash % (unsigned int)size);
+}
+
+// distinct non-negative keys: an odd multiplier permutes [0, 2^31)
+static int keyAt(int i) { return (int)(((unsigned int)i * 2654435761u) & 0x7fffffff); }
+
+template <class Map>
+static void mapRows(const string &label, int entries, Map *(*makeMap)(float), float loadFactor)
+{
+    Map *map = nullptr;
+    double insert = BENCH::bestOf(3, [&]() {
+        delete map;
+        map = makeMap(loadFactor);
+        for (int i = 0; i < entries; ++i) map->put(keyAt(i), i);
+    });
+    long long found = 0;
+    double hit = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < entries; ++i) found += map->get(keyAt(i));
+    });
+    double miss = BENCH::bestOf(3, [&]() {
+        for (int i = entries; i < 2 * entries; ++i) found += map->containsKey(keyAt(i));
+    });
+    double erase = BENCH::timeIt([&]() {
+        for (int i = 0; i < entries; i += 2) map->remove(keyAt(i));
+    });
+    double afterErase = BENCH::bestOf(3, [&]() {
+        for (int i = 1; i < entries; i += 2) found += map->get(keyAt(i));
+    });
+    if (found == 42) cout << "";
+    delete map;
+
+    BENCH::printRow(label + " insert", entries / insert / 1e6, "Mops/s");
+    BENCH::printRow(label + " hit", entries / hit / 1e6, "Mops/s");
+    BENCH::printRow(label + " miss", entries / miss / 1e6, "Mops/s");
+    BENCH::printRow(label + " erase half", entries / 2 / erase / 1e6, "Mops/s");
+    BENCH::printRow(label + " hit after erase", entries / 2 / afterErase / 1e6, "Mops/s");
+}
+
+static SwissMap<int, int> *makeSwiss(float)
+{
+    SwissMap<int, int> *map = new SwissMap<int, int>(&intHash);
+    map->reserve(swissSlots * 7 / 8);
+    return map;
+}
+
+static xMap<int, int> *makeChained(float loadFactor) { return new xMap<int, int>(&intHash, loadFactor); }
+
+void BENCH_Huffman::MapProbing()
+{
+    const float loads[4] = {0.25f, 0.5f, 0.75f, 0.875f};
+    for (float load : loads) {
+        int entries = (int)(load * swissSlots);
+        stringstream label;
+        label << fixed << setprecision(3) << load;
+        mapRows<SwissMap<int, int>>("swiss " + label.str(), entries, &makeSwiss, load);
+        mapRows<xMap<int, int>>("xMap  " + label.str(), entries, &makeChained, load);
+    }
+
+    // string keys (SKU-like names), each map at its default load factor
+    const int skus = 200000;
+    string *names = new string[2 * skus];
+    for (int i = 0; i < 2 * skus; ++i) names[i] = "SKU-" + to_string(keyAt(i) % 100000000);
+    SwissMap<string, int> swiss(&fnvHash);
+    xMap<string, int> chained(&fnvHash);
+    double swissInsert = BENCH::timeIt([&]() { for (int i = 0; i < skus; ++i) swiss.put(names[i], i); });
+    double chainedInsert = BENCH::timeIt([&]() { for (int i = 0; i < skus; ++i) chained.put(names[i], i); });
+    long long found = 0;
+    double swissHit = BENCH::bestOf(3, [&]() { for (int i = 0; i < skus; ++i) found += swiss.get(names[i]); });
+    double chainedHit = BENCH::bestOf(3, [&]() { for (int i = 0; i < skus; ++i) found += chained.get(names[i]); });
+    double swissMiss = BENCH::bestOf(3, [&]() { for (int i = skus; i < 2 * skus; ++i) found += swiss.containsKey(names[i]); });
+    double chainedMiss = BENCH::bestOf(3, [&]() { for (int i = skus; i < 2 * skus; ++i) found += chained.containsKey(names[i]); });
+    if (found == 42) cout << "";
+    delete[] names;
+
+    BENCH::printRow("swiss string insert", skus / swissInsert / 1e6, "Mops/s");
+    BENCH::printRow("xMap  string insert", skus / chainedInsert / 1e6, "Mops/s");
+    BENCH::printRow("swiss string hit", skus / swissHit / 1e6, "Mops/s");
+    BENCH::printRow("xMap  string hit", skus / chainedHit / 1e6, "Mops/s");
+    BENCH::printRow("swiss string miss", skus / swissMiss / 1e6, "Mops/s");
+    BENCH::printRow("xMap  string miss", skus / chainedMiss / 1e6, "Mops/s");
+}
@@ -0,0 +1,51 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * treeOrder chosen by the cost model vs. fixed orders 2, 4 and 16, on 200k
+ * products in text and binary form: estimated and measured bytes/product,
+ * and decodeAll throughput, for decodeWeight 0 (size only) and 2.
+ */
+template <int treeOrder>
+static void measureOrder(InventoryManager &inventory, SerializationMode mode, const string &label)
+{
+    InventoryCompressor<treeOrder> compressor(&inventory);
+    compressor.setSerializationMode(mode);
+    compressor.buildHuffman(true);
+    HuffmanBatch batch;
+    compressor.encodeAll(batch);
+    double decode = BENCH::bestOf(2, [&]() {
+        List2D<InventoryAttribute> rows;
+        List1D<string> names;
+        compressor.decodeAll(batch, rows, names);
+    });
+    double products = inventory.size();
+    double bytes = batch.bits() / 8.0 + compressor.codebookHeader().size();
+    BENCH::printRow(label + " order " + to_string(treeOrder) + " size", bytes / products, "bytes/product");
+    BENCH::printRow(label + " order " + to_string(treeOrder) + " decodeAll", products / decode / 1e3, "k products/s");
+}
+
+static void selectionFor(InventoryManager &inventory, SerializationMode mode, const string &label)
+{
+    measureOrder<2>(inventory, mode, label);
+    measureOrder<4>(inventory, mode, label);
+    measureOrder<16>(inventory, mode, label);
+
+    double chooseTime = 0;
+    for (double weight : {0.0, 2.0})
+    {
+        TreeOrderEstimate choice;
+        chooseTime = BENCH::timeIt([&]() { choice = chooseTreeOrder(&inventory, mode, weight); });
+        string name = label + " chosen (weight " + to_string((int)weight) + ")";
+        BENCH::printRow(name + ": order", choice.order, "");
+        BENCH::printRow(name + " estimated size", choice.bits / 8 / inventory.size(), "bytes/product");
+        withTreeOrder(choice.order, [&](auto order) { measureOrder<decltype(order)::value>(inventory, mode, name); });
+    }
+    BENCH::printRow(label + " chooseTreeOrder", chooseTime * 1e3, "ms");
+}
+
+void BENCH_Huffman::OrderSelection()
+{
+    InventoryManager inventory = makeInventory(200000);
+    selectionFor(inventory, TEXT_SERIALIZATION, "text");
+    selectionFor(inventory, BINARY_SERIALIZATION, "binary");
+}
@@ -0,0 +1,40 @@
+#include "../bench_Huffman.hpp"
+#include "util/parallelFor.h"
+
+/*
+ * Decoding a 200k-product block container on 1, 2, 4, ... threads against
+ * the serial decodeAll over the same products.
+ */
+void BENCH_Huffman::ParallelDecode()
+{
+    const int products = 200000;
+    InventoryManager inventory = makeInventory(products);
+    InventoryCompressor<4> compressor(&inventory);
+    compressor.buildHuffman();
+
+    HuffmanBatch batch;
+    compressor.encodeAll(batch);
+    double serial = BENCH::timeIt([&]() {
+        List2D<InventoryAttribute> rows;
+        List1D<string> names;
+        compressor.decodeAll(batch, rows, names);
+    });
+    string container = compressor.encodeContainer(1024);
+
+    BENCH::printRow("hardware threads", hardwareThreads(), "");
+    BENCH::printRow("container overhead", (container.size() - batch.data.size()) / (double)products, "bytes/product");
+    BENCH::printRow("serial decodeAll", products / serial / 1e3, "k products/s");
+
+    int maxThreads = hardwareThreads() < 4 ? 4 : hardwareThreads();
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        compressor.setThreadCount(threads);
+        double seconds = BENCH::timeIt([&]() {
+            List2D<InventoryAttribute> rows;
+            List1D<string> names;
+            compressor.decodeContainer(container, rows, names);
+        });
+        string label = "decodeContainer, " + to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+        BENCH::printRow(label, products / seconds / 1e3, "k products/s");
+    }
+}
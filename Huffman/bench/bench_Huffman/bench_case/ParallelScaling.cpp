@@ -0,0 +1,36 @@
+#include "../bench_Huffman.hpp"
+#include "util/parallelFor.h"
+
+/*
+ * buildHuffman (chunked histograms + merge) and encodeAll (parallel blocks)
+ * on a 1M-product inventory, for 1, 2, 4, ... threads up to the hardware
+ * thread count (and at least 4, to show the overhead when oversubscribed).
+ */
+void BENCH_Huffman::ParallelScaling()
+{
+    InventoryManager inventory = makeInventory(1000000);
+    InventoryCompressor<4> compressor(&inventory);
+
+    int maxThreads = hardwareThreads() < 4 ? 4 : hardwareThreads();
+    BENCH::printRow("hardware threads", hardwareThreads(), "");
+
+    double serialBuild = 0, serialEncode = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        compressor.setThreadCount(threads);
+        double build = BENCH::bestOf(3, [&]() { compressor.buildHuffman(); });
+        HuffmanBatch batch;
+        double encode = BENCH::bestOf(3, [&]() { compressor.encodeAll(batch); });
+        if (threads == 1)
+        {
+            serialBuild = build;
+            serialEncode = encode;
+        }
+
+        string label = to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+        BENCH::printRow(label + " buildHuffman", build * 1e3, "ms");
+        BENCH::printRow(label + " encodeAll", encode * 1e3, "ms");
+        BENCH::printRow(label + " build speedup", serialBuild / build, "x");
+        BENCH::printRow(label + " encode speedup", serialEncode / encode, "x");
+    }
+}
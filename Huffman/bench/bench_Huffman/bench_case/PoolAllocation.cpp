@@ -0,0 +1,59 @@
+#include "../bench_Huffman.hpp"
+#include <fstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * xMap<int, int> filled with 10M keys, entries and bucket nodes from new /
+ * delete vs. an exclusive PoolAllocator: put throughput, resident memory the
+ * filled map adds (RSS from /proc/self/statm, Linux only) and the time clear()
+ * takes. Each run is a child process of its own (POSIX fork): a run that
+ * follows another in the same process inherits its heap of freed small
+ * blocks, which skews both the RSS figure and the put rate.
+ */
+static int poolHash(int &key, int size) { return key % size; }
+
+static double residentMB()
+{
+    long pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    return (double)resident * sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+void BENCH_Huffman::PoolAllocation()
+{
+    const int keys = 10000000;
+
+    for (int pooled = 1; pooled >= 0; --pooled) {
+        cout.flush();
+        pid_t child = fork();
+        if (child > 0) {
+            waitpid(child, nullptr, 0);
+            continue;
+        }
+
+        string label = pooled ? "pool" : "new/delete";
+        PoolAllocator *pool = pooled ? new PoolAllocator() : nullptr;
+        xMap<int, int> *map = new xMap<int, int>(&poolHash);
+        if (pooled) map->setAllocator(pool, true);
+
+        double before = residentMB();
+        double seconds = BENCH::timeIt([&]() {
+            for (int i = 0; i < keys; ++i) map->put((int)(((unsigned int)i * 2654435761u) & 0x7fffffff), i);
+        });
+        double grown = residentMB() - before;
+        BENCH::printRow(label + " put", keys / seconds / 1e6, "Mops/s");
+        BENCH::printRow(label + " RSS growth", grown, "MB");
+        BENCH::printRow(label + " bytes per key", grown * (1 << 20) / keys, "B");
+
+        seconds = BENCH::timeIt([&]() { map->clear(); });
+        BENCH::printRow(label + " clear", seconds * 1e3, "ms");
+        delete map;
+        delete pool;
+        if (child == 0) {
+            cout.flush();
+            _exit(0);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "../bench_Huffman.hpp"
+#include <algorithm>
+
+/*
+ * Per-operation latency of xMap::put while it grows to 2M keys, with
+ * stop-the-world rehash vs. incremental rehash (8 old buckets per
+ * operation): percentiles, worst case and total time. Then the same for
+ * get on a map that is mid-migration. The incremental run goes first: the
+ * millions of small blocks a finished run has freed make the next run's
+ * first allocations sort them (glibc), a stall of its own in either mode.
+ */
+static int latencyHash(int &key, int size) { return key % size; }
+
+static int latencyKey(int i) { return (int)(((unsigned int)i * 2654435761u) & 0x7fffffff); }
+
+static void latencyRows(const string &label, double *nanos, int count, double total)
+{
+    std::sort(nanos, nanos + count);
+    BENCH::printRow(label + " p50", nanos[count / 2], "ns");
+    BENCH::printRow(label + " p99", nanos[(int)(count * 0.99)], "ns");
+    BENCH::printRow(label + " p999", nanos[(int)(count * 0.999)], "ns");
+    BENCH::printRow(label + " max", nanos[count - 1] / 1e6, "ms");
+    BENCH::printRow(label + " total", total * 1e3, "ms");
+}
+
+void BENCH_Huffman::RehashLatency()
+{
+    const int keys = 2000000;
+    double *nanos = new double[keys];
+
+    xMap<int, int> *maps[2] = {nullptr, nullptr};
+    for (int incremental = 1; incremental >= 0; --incremental) {
+        string label = incremental ? "incremental" : "all at once";
+        maps[incremental] = new xMap<int, int>(&latencyHash);
+        xMap<int, int> &map = *maps[incremental];
+        if (incremental) map.setIncrementalRehash(8);
+
+        double total = BENCH::timeIt([&]() {
+            for (int i = 0; i < keys; ++i) {
+                auto start = chrono::steady_clock::now();
+                map.put(latencyKey(i), i);
+                nanos[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            }
+        });
+        latencyRows(label + " put", nanos, keys, total);
+
+        // one more put starts a growth; time the gets that follow it
+        int extra = keys, capacity = map.getCapacity();
+        while (map.getCapacity() == capacity) map.put(latencyKey(extra++), 0);
+        long long sum = 0;
+        total = BENCH::timeIt([&]() {
+            for (int i = 0; i < keys; ++i) {
+                auto start = chrono::steady_clock::now();
+                sum += map.get(latencyKey(i));
+                nanos[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            }
+        });
+        if (sum == 42) cout << "";
+        latencyRows(label + " get", nanos, keys, total);
+    }
+    delete maps[0];
+    delete maps[1];
+    delete[] nanos;
+}
@@ -0,0 +1,82 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * xMap<string, int> with 200K SKU keys (FNV-1a hash): the lookup patterns
+ * callers used before find / findOrPut, next to the single-probe forms.
+ *  + containsKey + get vs. find
+ *  + containsKey + put (get-or-insert, half the keys new) vs. findOrPut
+ *  + SKUs cut from one comma-separated line: get(string(view)) vs.
+ *      find(hash of the view, view), which builds no string
+ */
+static unsigned int fnv(string_view key)
+{
+    unsigned int hash = 2166136261u;
+    for (char c : key) hash = (hash ^ (unsigned char)c) * 16777619u;
+    return hash;
+}
+
+static int skuHash(string &key, int size) { return (int)(fnv(key) % (unsigned int)size); }
+
+void BENCH_Huffman::StringLookups()
+{
+    const int skus = 200000;
+    string *keys = new string[2 * skus];
+    string line;
+    for (int i = 0; i < 2 * skus; ++i) {
+        keys[i] = "SKU-" + to_string(i * 7919LL % 1000003) + "-EU";
+        if (i < skus) line += keys[i] + (i + 1 < skus ? "," : "");
+    }
+    xMap<string, int> map(&skuHash);
+    for (int i = 0; i < skus; ++i) map.put(keys[i], i);
+
+    long long sum = 0;
+    double seconds = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < skus; ++i)
+            if (map.containsKey(keys[i])) sum += map.get(keys[i]);
+    });
+    BENCH::printRow("containsKey + get", skus / seconds / 1e6, "Mops/s");
+    seconds = BENCH::bestOf(3, [&]() {
+        for (int i = 0; i < skus; ++i) {
+            xMap<string, int>::Entry *entry = map.find(keys[i]);
+            if (entry != nullptr) sum += entry->getValue();
+        }
+    });
+    BENCH::printRow("find", skus / seconds / 1e6, "Mops/s");
+
+    for (int onePass = 0; onePass <= 1; ++onePass) {
+        xMap<string, int> ids(&skuHash);
+        for (int i = 0; i < skus; i += 2) ids.put(keys[i], i);
+        seconds = BENCH::timeIt([&]() {
+            for (int i = 0; i < skus; ++i) {
+                if (onePass) {
+                    ids.findOrPut(keys[i], ids.size());
+                } else if (!ids.containsKey(keys[i])) {
+                    ids.put(keys[i], ids.size());
+                }
+            }
+        });
+        BENCH::printRow(onePass ? "get-or-insert, findOrPut" : "get-or-insert, containsKey + put",
+                        skus / seconds / 1e6, "Mops/s");
+    }
+
+    for (int views = 0; views <= 1; ++views) {
+        seconds = BENCH::bestOf(3, [&]() {
+            string_view rest(line);
+            while (!rest.empty()) {
+                size_t comma = rest.find(',');
+                string_view sku = rest.substr(0, comma);
+                if (views) {
+                    xMap<string, int>::Entry *entry = map.find((int)(fnv(sku) % INT_MAX), sku);
+                    if (entry != nullptr) sum += entry->getValue();
+                } else {
+                    sum += map.get(string(sku));
+                }
+                rest = (comma == string_view::npos) ? string_view() : rest.substr(comma + 1);
+            }
+        });
+        BENCH::printRow(views ? "parsed line, find(hash, view)" : "parsed line, get(string(view))",
+                        skus / seconds / 1e6, "Mops/s");
+    }
+    if (sum == 42) cout << "";
+    delete[] keys;
+}
@@ -0,0 +1,133 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Text product parsing on 200k productToString lines: the former
+ * decodeHuffman parser (substr per attribute, char-by-char key/value
+ * strings, a stringstream per number) against parseProduct.
+ */
+static std::string legacyParse(const std::string &decoded, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{   
+    attributesOutput = List1D<InventoryAttribute>();
+    nameOutput = "";
+
+    if (decoded.find("\\x00") != std::string::npos)  return "\\x00";
+
+    size_t nameDelimiter = decoded.find(':');
+    if (nameDelimiter == std::string::npos) return "\\x00";
+
+    nameOutput = decoded.substr(0, nameDelimiter);
+    if (nameOutput.empty()) return "";
+
+    size_t firstAttrPos = decoded.find('(', nameDelimiter);
+    
+    if (firstAttrPos == std::string::npos) {
+        if (nameDelimiter != decoded.length() - 1)
+            return "";
+            
+        return decoded; 
+    }
+    
+    std::string attrPart = decoded.substr(nameDelimiter + 1);
+    size_t pos = 0;
+    
+    while (pos < attrPart.length()) {
+        size_t openParen = attrPart.find('(', pos);
+        if (openParen == std::string::npos)
+            break;
+            
+        size_t closeParen = attrPart.find(')', openParen);
+        if (closeParen == std::string::npos)
+            return ""; 
+            
+        std::string attrStr = attrPart.substr(openParen + 1, closeParen - openParen - 1);
+        
+        enum ParseState { KEY_SECTION, VALUE_SECTION };
+        ParseState state = KEY_SECTION;
+        
+        std::string attributeName;
+        std::string attributeValue;
+        
+        for (size_t i = 0; i < attrStr.length(); i++) {
+            char currentChar = attrStr[i];
+            
+            if (currentChar == ':' && state == KEY_SECTION) {
+                state = VALUE_SECTION;
+                attributeName = attributeName.substr(0, attributeName.find_last_not_of(" \t") + 1);
+                continue;
+            }
+            
+            if (state == KEY_SECTION) {
+                attributeName += currentChar;
+            } else {
+                attributeValue += currentChar;
+            }
+        }
+        
+        if (attributeName.empty()) {
+            return decoded;
+        }
+        
+        while (!attributeValue.empty() && (attributeValue[0] == ' ' || attributeValue[0] == '\t')) {
+            attributeValue.erase(0, 1);
+        }
+        
+        try {
+            double numericValue = 0.0;
+            std::stringstream ss(attributeValue);
+            ss >> numericValue;
+            
+            if (ss.fail()) {
+                throw std::runtime_error("Invalid format");
+            }
+            
+            attributesOutput.add(InventoryAttribute(attributeName, numericValue));
+        } catch (...) {
+            return "";
+        }
+        
+        pos = closeParen + 1;
+        
+        if (pos < attrPart.length() && attrPart[pos] == ',') {
+            pos++;
+            while (pos < attrPart.length() && attrPart[pos] == ' ')
+                pos++;
+        }
+    }
+    
+    return decoded;
+}
+
+void BENCH_Huffman::TextParse()
+{
+    InventoryManager inventory = makeInventory(200000);
+    InventoryCompressor<4> compressor(&inventory);
+    List1D<string> lines;
+    double attributes = 0;
+    for (int i = 0; i < inventory.size(); ++i)
+    {
+        lines.add(compressor.productToString(inventory.getProductAttributes(i), inventory.getProductName(i)));
+        attributes += inventory.getAttributeCount(i);
+    }
+
+    int legacyClean = 0, clean = 0;
+    double legacy = BENCH::bestOf(3, [&]() {
+        legacyClean = 0;
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        for (int i = 0; i < lines.size(); ++i)
+            legacyClean += legacyParse(lines.at(i), attributesOutput, nameOutput) == lines.at(i);
+    });
+    double current = BENCH::bestOf(3, [&]() {
+        clean = 0;
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        for (int i = 0; i < lines.size(); ++i)
+            clean += compressor.parseProduct(lines.at(i), attributesOutput, nameOutput) == lines.at(i);
+    });
+
+    BENCH::printRow("stringstream parser", attributes / legacy / 1e6, "M attributes/s");
+    BENCH::printRow("string_view + from_chars", attributes / current / 1e6, "M attributes/s");
+    BENCH::printRow("speedup", legacy / current, "x");
+    if (clean != legacyClean || clean != lines.size())
+        BENCH::printRow("FAILED parses", lines.size() - clean, "");
+}
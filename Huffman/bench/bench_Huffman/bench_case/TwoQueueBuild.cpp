@@ -0,0 +1,38 @@
+#include "../bench_Huffman.hpp"
+
+/*
+ * Heap-based build() vs. buildTwoQueue() on a full 256-symbol alphabet.
+ */
+template <int treeOrder>
+static void twoQueueFor(XArrayList<pair<char, int>> &freqs)
+{
+    const int rounds = 2000;
+    HuffmanTree<treeOrder> tree;
+    double heapBuild = BENCH::bestOf(3, [&]() {
+        for (int r = 0; r < rounds; ++r) tree.build(freqs);
+    });
+    double queueBuild = BENCH::bestOf(3, [&]() {
+        for (int r = 0; r < rounds; ++r) tree.buildTwoQueue(freqs);
+    });
+
+    string label = "order " + to_string(treeOrder);
+    BENCH::printRow(label + " heap build()", heapBuild / rounds * 1e6, "us");
+    BENCH::printRow(label + " buildTwoQueue()", queueBuild / rounds * 1e6, "us");
+}
+
+void BENCH_Huffman::TwoQueueBuild()
+{
+    XArrayList<pair<char, int>> freqs;
+    unsigned int seed = 99;
+    for (int c = 0; c < 256; ++c)
+    {
+        seed = seed * 1103515245u + 12345u;
+        freqs.add({(char)c, 1 + (int)((seed >> 16) % 5000)});
+    }
+
+    twoQueueFor<2>(freqs);
+    twoQueueFor<3>(freqs);
+    twoQueueFor<4>(freqs);
+    twoQueueFor<8>(freqs);
+    twoQueueFor<16>(freqs);
+}
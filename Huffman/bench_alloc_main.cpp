@@ -0,0 +1,83 @@
+/*
+ * file : bench_alloc_main.cpp
+ * Allocation counts of HuffmanTree build() and ~HuffmanTree()
+ *
+ * A binary of its own: counting means replacing the global operator new /
+ * delete, which would otherwise add its bookkeeping to every allocation of
+ * every benchmark linked next to it.
+ */
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "app/inventory_compressor.h"
+#include "bench.hpp"
+
+static std::atomic<long long> allocationCount(0);
+static std::atomic<long long> releaseCount(0);
+
+static void *countedAllocate(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+static void countedRelease(void *p)
+{
+  if (p != nullptr)
+    releaseCount.fetch_add(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+void *operator new(std::size_t size) { return countedAllocate(size); }
+void *operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void *p) noexcept { countedRelease(p); }
+void operator delete[](void *p) noexcept { countedRelease(p); }
+void operator delete(void *p, std::size_t) noexcept { countedRelease(p); }
+void operator delete[](void *p, std::size_t) noexcept { countedRelease(p); }
+
+template <int treeOrder>
+static void allocationsFor(XArrayList<pair<char, int>> &freqs)
+{
+  const int rounds = 2000;
+  long long buildAllocs = 0, teardownAllocs = 0, teardownReleases = 0;
+  double buildSeconds = 0, teardownSeconds = 0;
+  for (int r = 0; r < rounds; ++r)
+  {
+    HuffmanTree<treeOrder> *tree = new HuffmanTree<treeOrder>();
+    long long before = allocationCount.load();
+    buildSeconds += BENCH::timeIt([&]() { tree->build(freqs); });
+    buildAllocs += allocationCount.load() - before;
+
+    before = allocationCount.load();
+    long long releasedBefore = releaseCount.load();
+    teardownSeconds += BENCH::timeIt([&]() { delete tree; });
+    teardownAllocs += allocationCount.load() - before;
+    // the tree object itself is not part of its teardown
+    teardownReleases += releaseCount.load() - releasedBefore - 1;
+  }
+
+  string label = "order " + to_string(treeOrder);
+  BENCH::printRow(label + " build() allocations", (double)buildAllocs / rounds, "allocs");
+  BENCH::printRow(label + " build()", buildSeconds / rounds * 1e6, "us");
+  BENCH::printRow(label + " ~HuffmanTree() allocations", (double)teardownAllocs / rounds, "allocs");
+  BENCH::printRow(label + " ~HuffmanTree() frees", (double)teardownReleases / rounds, "frees");
+  BENCH::printRow(label + " ~HuffmanTree()", teardownSeconds / rounds * 1e6, "us");
+}
+
+int main()
+{
+  // full byte alphabet with a skewed distribution
+  XArrayList<pair<char, int>> freqs;
+  for (int c = 0; c < 256; ++c)
+    freqs.add({(char)c, 1 + (c * c) % 997});
+
+  allocationsFor<2>(freqs);
+  allocationsFor<4>(freqs);
+  allocationsFor<8>(freqs);
+  allocationsFor<16>(freqs);
+  return 0;
+}
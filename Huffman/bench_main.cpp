@@ -0,0 +1,27 @@
+/*
+ * file : bench_main.cpp
+ * Benchmark driver for the Huffman / InventoryCompressor modules
+ */
+#include <iostream>
+#include <string>
+#include "bench_Huffman.hpp"
+
+int main(int argc, char *argv[])
+{
+  BENCH_Huffman bench;
+
+  if (argc == 1 || (argc == 2 && std::string(argv[1]) == "all"))
+  {
+    bench.runAllBenches();
+  }
+  else if (argc == 2)
+  {
+    bench.runBench(argv[1]);
+  }
+  else
+  {
+    std::cout << "Usage: ./benchmark [benchName]" << std::endl;
+    return 1;
+  }
+  return 0;
+}
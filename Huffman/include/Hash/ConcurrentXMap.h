@@ -0,0 +1,201 @@
+#ifndef CONCURRENTXMAP_H
+#define CONCURRENTXMAP_H
+#include <climits>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+using namespace std;
+
+#include "hash/xMap.h"
+
+/*
+ * ConcurrentXMap<K, V>: a map many threads may use at once, built from
+ * `shards` xMap<K, V>, each behind its own reader-writer lock.
+ *  + K: key type
+ *  + V: value type
+ *
+ * A key lives in one shard, picked from xMap's hashCode callback: it is
+ * called once, as hashCode(key, INT_MAX) (xMap::hashOf), and mixed like
+ * SwissMap does, so the shard does not follow the bucket index inside the
+ * shard; the unmixed value is handed on to the shard's find / findOrPut, so
+ * no operation but remove hashes twice. get / tryGet /
+ * containsKey take their shard's lock shared, put / remove exclusive, so
+ * threads only wait for each other on the same shard, and readers not even
+ * then. Whole-map operations (size, keys, clear) lock every shard, always in
+ * index order, and hold them all until done: keys() is a snapshot of one
+ * instant, never a mix of states before and after some put.
+ *
+ * get returns a copy of the value: a reference would outlive the lock.
+ * The shards never use incremental rehash, whose lookups move buckets and so
+ * could not run under a shared lock. Not copyable.
+ */
+template <class K, class V>
+class ConcurrentXMap
+{
+protected:
+    struct alignas(64) Shard {   // one cache line apart: no false sharing of the locks
+        shared_mutex lock;
+        xMap<K, V> *map;
+    };
+
+    Shard *shards;
+    int shardCount;
+    int (*hashCode)(K &, int);   // hashCode(K key, int tableSize), as in xMap
+
+public:
+    ConcurrentXMap(
+        int (*hashCode)(K &, int), // require
+        int shards = 16,
+        float loadFactor = 0.75f,
+        bool (*valueEqual)(V &, V &) = 0,
+        void (*deleteValues)(xMap<K, V> *) = 0,
+        bool (*keyEqual)(K &, K &) = 0,
+        void (*deleteKeys)(xMap<K, V> *) = 0);
+    ConcurrentXMap(const ConcurrentXMap<K, V> &map) = delete;
+    ConcurrentXMap<K, V> &operator=(const ConcurrentXMap<K, V> &map) = delete;
+    ~ConcurrentXMap();
+
+    V put(const K &key, V value);
+    V get(const K &key);                // KeyNotFound if absent
+    bool tryGet(const K &key, V &value); // false if absent
+    V remove(const K &key, void (*deleteKeyInMap)(K) = 0);
+    bool containsKey(const K &key);
+    int size();
+    bool empty() { return size() == 0; }
+    void clear();
+    DLinkedList<K> keys();
+
+    int getShardCount() { return shardCount; }
+
+protected:
+    int hashOf(const K &key)
+    {
+        return hashCode(const_cast<K &>(key), INT_MAX);
+    }
+    Shard &shardOf(int hash)
+    {
+        unsigned long long mixed = (unsigned long long)(unsigned int)hash * 0x9E3779B97F4A7C15ULL;
+        return shards[(mixed >> 32) % shardCount];
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class K, class V>
+ConcurrentXMap<K, V>::ConcurrentXMap(
+    int (*hashCode)(K &, int),
+    int shards,
+    float loadFactor,
+    bool (*valueEqual)(V &, V &),
+    void (*deleteValues)(xMap<K, V> *),
+    bool (*keyEqual)(K &, K &),
+    void (*deleteKeys)(xMap<K, V> *))
+{
+    this->hashCode = hashCode;
+    this->shardCount = (shards < 1) ? 1 : shards;
+    this->shards = new Shard[shardCount];
+    for (int idx = 0; idx < shardCount; idx++) {
+        this->shards[idx].map = new xMap<K, V>(hashCode, loadFactor, valueEqual, deleteValues, keyEqual, deleteKeys);
+    }
+}
+
+template <class K, class V>
+ConcurrentXMap<K, V>::~ConcurrentXMap()
+{
+    for (int idx = 0; idx < shardCount; idx++) delete shards[idx].map;
+    delete[] shards;
+}
+
+template <class K, class V>
+V ConcurrentXMap<K, V>::put(const K &key, V value)
+{
+    int hash = hashOf(key);
+    Shard &shard = shardOf(hash);
+    unique_lock<shared_mutex> guard(shard.lock);
+    bool inserted;
+    typename xMap<K, V>::Entry *entry = shard.map->findOrPut(hash, key, value, &inserted);
+    if (inserted) return value;
+    V previousValue = entry->getValue();
+    entry->getValue() = value;
+    return previousValue;
+}
+
+template <class K, class V>
+V ConcurrentXMap<K, V>::get(const K &key)
+{
+    V value;
+    if (tryGet(key, value)) return value;
+
+    stringstream os;
+    os << "key (" << key << ") is not found";
+    throw KeyNotFound(os.str());
+}
+
+template <class K, class V>
+bool ConcurrentXMap<K, V>::tryGet(const K &key, V &value)
+{
+    int hash = hashOf(key);
+    Shard &shard = shardOf(hash);
+    shared_lock<shared_mutex> guard(shard.lock);
+    typename xMap<K, V>::Entry *entry = shard.map->find(hash, key);
+    if (entry == nullptr) return false;
+    value = entry->getValue();
+    return true;
+}
+
+template <class K, class V>
+V ConcurrentXMap<K, V>::remove(const K &key, void (*deleteKeyInMap)(K))
+{
+    Shard &shard = shardOf(hashOf(key));
+    unique_lock<shared_mutex> guard(shard.lock);
+    return shard.map->remove(key, deleteKeyInMap);
+}
+
+template <class K, class V>
+bool ConcurrentXMap<K, V>::containsKey(const K &key)
+{
+    int hash = hashOf(key);
+    Shard &shard = shardOf(hash);
+    shared_lock<shared_mutex> guard(shard.lock);
+    return shard.map->find(hash, key) != nullptr;
+}
+
+template <class K, class V>
+int ConcurrentXMap<K, V>::size()
+{
+    for (int idx = 0; idx < shardCount; idx++) shards[idx].lock.lock_shared();
+    int total = 0;
+    for (int idx = 0; idx < shardCount; idx++) total += shards[idx].map->size();
+    for (int idx = shardCount - 1; idx >= 0; idx--) shards[idx].lock.unlock_shared();
+    return total;
+}
+
+template <class K, class V>
+void ConcurrentXMap<K, V>::clear()
+{
+    for (int idx = 0; idx < shardCount; idx++) shards[idx].lock.lock();
+    for (int idx = 0; idx < shardCount; idx++) shards[idx].map->clear();
+    for (int idx = shardCount - 1; idx >= 0; idx--) shards[idx].lock.unlock();
+}
+
+template <class K, class V>
+DLinkedList<K> ConcurrentXMap<K, V>::keys()
+{
+    DLinkedList<K> keyList;
+    for (int idx = 0; idx < shardCount; idx++) shards[idx].lock.lock_shared();
+    try {
+        for (int idx = 0; idx < shardCount; idx++) {
+            DLinkedList<K> shardKeys = shards[idx].map->keys();
+            for (K &key : shardKeys) keyList.add(key);
+        }
+    } catch (...) {
+        for (int idx = shardCount - 1; idx >= 0; idx--) shards[idx].lock.unlock_shared();
+        throw;
+    }
+    for (int idx = shardCount - 1; idx >= 0; idx--) shards[idx].lock.unlock_shared();
+    return keyList;
+}
+
+#endif /* CONCURRENTXMAP_H */
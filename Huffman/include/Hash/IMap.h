@@ -64,7 +64,7 @@
          + associate key with the new value (passed as parameter) 
          + return the old value
      */
-     virtual V put(K key, V value)=0;
+     virtual V put(const K& key, V value)=0;
      
      /*
      get(K key):
@@ -72,7 +72,7 @@
       else: KeyNotFound exception thrown
  
      */
-     virtual V& get(K key)=0;
+     virtual V& get(const K& key)=0;
      
      /*
      remove(K key):
@@ -81,7 +81,7 @@
      
      >> deleteKeyInMap(K key): delete key stored in map; in cases, K is a pointer type
      */
-     virtual V remove(K key, void (*deleteKeyInMap)(K)=0)=0;
+     virtual V remove(const K& key, void (*deleteKeyInMap)(K)=0)=0;
      
      /*
      remove(K key, V value):
@@ -91,14 +91,14 @@
      >> deleteKeyInMap(K key): delete key stored in map; in cases, K is a pointer type
      >> deleteValueInMap(V value): delete key stored in map; in cases, V is a pointer type
      */
-     virtual bool remove(K key, V value, void (*deleteKeyInMap)(K)=0, void (*deleteValueInMap)(V)=0)=0;
+     virtual bool remove(const K& key, V value, void (*deleteKeyInMap)(K)=0, void (*deleteValueInMap)(V)=0)=0;
      
      /*
      containsKey(K key):
      if key is in the map: return true
      else: return false
      */
-     virtual bool containsKey(K key)=0;
+     virtual bool containsKey(const K& key)=0;
      
      /*
      containsKey(V value):
@@ -0,0 +1,537 @@
+#ifndef SWISSMAP_H
+#define SWISSMAP_H
+#include <climits>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+using namespace std;
+
+#include "list/DLinkedList.h"
+#include "hash/IMap.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISSMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * SwissMap<K, V>: open-addressing hash map ("Swiss table") with the IMap
+ * interface of xMap, so either can sit behind an IMap<K, V>&.
+ *  + K: key type
+ *  + V: value type
+ *
+ * Storage is three parallel arrays (SoA) of capacity slots: one control byte,
+ * one key and one value per slot. The control byte says EMPTY, DELETED
+ * (tombstone) or, for a full slot, 7 bits of the key's mixed hash (H2).
+ * Slots are probed in aligned groups of 16: the 16 control bytes of a group
+ * are compared with H2 in one SSE2 instruction (a scalar loop elsewhere), and
+ * only the slots that match have their key compared. A lookup starts at the
+ * group picked by the rest of the hash (H1) and visits groups in triangular
+ * order, stopping at the first group that still has an EMPTY slot.
+ *
+ * hashCode is xMap's callback: it is called as hashCode(key, INT_MAX) and the
+ * result is mixed, so the same functions serve both maps. The table doubles
+ * when full + deleted slots would exceed loadFactor * capacity (or is rebuilt
+ * at the same size when most of that is tombstones). loadFactor is clamped to
+ * [minLoadFactor, maxLoadFactor]: a table must keep EMPTY slots, or a lookup
+ * for a missing key would never find a group to stop at.
+ */
+template <class K, class V>
+class SwissMap : public IMap<K, V>
+{
+public:
+    static const int groupWidth = 16;
+    static constexpr float minLoadFactor = 0.0625f;
+    static constexpr float maxLoadFactor = 0.875f;
+
+protected:
+    enum : signed char { EMPTY = -128, DELETED = -2 };
+
+    signed char *control;   // capacity control bytes
+    K *keySlots;            // capacity keys
+    V *valueSlots;          // capacity values
+    int capacity;           // number of slots: a power of two, >= groupWidth
+    int count;              // full slots
+    int tombstones;         // DELETED slots
+    float loadFactor;       // max (count + tombstones) / capacity
+    int (*hashCode)(K &, int);
+    bool (*keyEqual)(K &, K &);
+    bool (*valueEqual)(V &, V &);
+    void (*deleteKeys)(SwissMap<K, V> *);
+    void (*deleteValues)(SwissMap<K, V> *);
+
+public:
+    SwissMap(
+        int (*hashCode)(K &, int), // require
+        float loadFactor = 0.875f,
+        bool (*valueEqual)(V &, V &) = 0,
+        void (*deleteValues)(SwissMap<K, V> *) = 0,
+        bool (*keyEqual)(K &, K &) = 0,
+        void (*deleteKeys)(SwissMap<K, V> *) = 0);
+
+    SwissMap(const SwissMap<K, V> &map);
+    SwissMap<K, V> &operator=(const SwissMap<K, V> &map);
+    ~SwissMap();
+
+    // Inherit from IMap:BEGIN
+    V put(const K &key, V value);
+    V &get(const K &key);
+    V remove(const K &key, void (*deleteKeyInMap)(K) = 0);
+    bool remove(const K &key, V value, void (*deleteKeyInMap)(K) = 0, void (*deleteValueInMap)(V) = 0);
+    bool containsKey(const K &key);
+    bool containsValue(V value);
+    bool empty();
+    int size();
+    void clear();
+    string toString(string (*key2str)(K &) = 0, string (*value2str)(V &) = 0);
+    DLinkedList<K> keys();
+    DLinkedList<V> values();
+    DLinkedList<int> clashes();
+    // Inherit from IMap:END
+
+    void println(string (*key2str)(K &) = 0, string (*value2str)(V &) = 0)
+    {
+        cout << this->toString(key2str, value2str) << endl;
+    }
+    int getCapacity()
+    {
+        return capacity;
+    }
+    // Size the table so that `entries` keys fit without growing.
+    void reserve(int entries);
+
+    /*
+     * freeKey / freeValue(SwissMap<K,V> *pMap): delete the keys / values of
+     * every full slot; for K / V pointer types, as with xMap.
+     */
+    static void freeKey(SwissMap<K, V> *pMap)
+    {
+        for (int slot = 0; slot < pMap->capacity; slot++)
+            if (pMap->control[slot] >= 0) delete pMap->keySlots[slot];
+    }
+    static void freeValue(SwissMap<K, V> *pMap)
+    {
+        for (int slot = 0; slot < pMap->capacity; slot++)
+            if (pMap->control[slot] >= 0) delete pMap->valueSlots[slot];
+    }
+
+protected:
+    struct Probe {
+        unsigned long long hash;
+        int group;
+        int step;
+        signed char h2;
+    };
+
+    Probe startProbe(const K &key);
+    void nextGroup(Probe &probe) { probe.group = (probe.group + ++probe.step) & (capacity / groupWidth - 1); }
+    int homeGroup(const K &key) { return startProbe(key).group; }
+
+    // bit i of the result is set for slot i of the group whose byte matches
+    unsigned int matchByte(int group, signed char byte) const;
+    unsigned int matchEmpty(int group) const { return matchByte(group, EMPTY); }
+    unsigned int matchFree(int group) const;   // EMPTY or DELETED
+    static int lowestBit(unsigned int mask);
+
+    int findSlot(const K &key);   // slot holding key, -1 if absent
+    void eraseSlot(int slot);
+    void ensureLoadFactor();
+    void rehash(int newCapacity);
+    void allocate(int newCapacity);
+    void removeInternalData();
+    void copyMapFrom(const SwissMap<K, V> &map);
+
+    bool keyEQ(K &lhs, K &rhs)
+    {
+        return (keyEqual != 0) ? keyEqual(lhs, rhs) : lhs == rhs;
+    }
+    bool valueEQ(V &lhs, V &rhs)
+    {
+        return (valueEqual != 0) ? valueEqual(lhs, rhs) : lhs == rhs;
+    }
+    void throwNotFound(const K &key)
+    {
+        stringstream os;
+        os << "key (" << key << ") is not found";
+        throw KeyNotFound(os.str());
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class K, class V>
+SwissMap<K, V>::SwissMap(
+    int (*hashCode)(K &, int),
+    float loadFactor,
+    bool (*valueEqual)(V &, V &),
+    void (*deleteValues)(SwissMap<K, V> *),
+    bool (*keyEqual)(K &, K &),
+    void (*deleteKeys)(SwissMap<K, V> *))
+{
+    if (!(loadFactor >= minLoadFactor)) loadFactor = minLoadFactor;
+    if (loadFactor > maxLoadFactor) loadFactor = maxLoadFactor;
+    this->loadFactor = loadFactor;
+    this->hashCode = hashCode;
+    this->valueEqual = valueEqual;
+    this->keyEqual = keyEqual;
+    this->deleteKeys = deleteKeys;
+    this->deleteValues = deleteValues;
+    allocate(groupWidth);
+}
+
+template <class K, class V>
+SwissMap<K, V>::SwissMap(const SwissMap<K, V> &map)
+{
+    copyMapFrom(map);
+    this->deleteKeys = nullptr;
+    this->deleteValues = nullptr;
+}
+
+template <class K, class V>
+SwissMap<K, V> &SwissMap<K, V>::operator=(const SwissMap<K, V> &map)
+{
+    if (this != &map) {
+        removeInternalData();
+        copyMapFrom(map);
+    }
+    return *this;
+}
+
+template <class K, class V>
+SwissMap<K, V>::~SwissMap()
+{
+    removeInternalData();
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// IMPLEMENTATION of IMap    ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class K, class V>
+V SwissMap<K, V>::put(const K &key, V value)
+{
+    int slot = findSlot(key);
+    if (slot >= 0) {
+        V previousValue = valueSlots[slot];
+        valueSlots[slot] = value;
+        return previousValue;
+    }
+
+    ensureLoadFactor();
+    Probe probe = startProbe(key);
+    unsigned int free = matchFree(probe.group);
+    while (free == 0) {
+        nextGroup(probe);
+        free = matchFree(probe.group);
+    }
+    slot = probe.group * groupWidth + lowestBit(free);
+    if (control[slot] == DELETED) tombstones--;
+    control[slot] = probe.h2;
+    keySlots[slot] = key;
+    valueSlots[slot] = value;
+    count++;
+    return value;
+}
+
+template <class K, class V>
+V &SwissMap<K, V>::get(const K &key)
+{
+    int slot = findSlot(key);
+    if (slot < 0) throwNotFound(key);
+    return valueSlots[slot];
+}
+
+template <class K, class V>
+V SwissMap<K, V>::remove(const K &key, void (*deleteKeyInMap)(K))
+{
+    int slot = findSlot(key);
+    if (slot < 0) throwNotFound(key);
+
+    V removedValue = valueSlots[slot];
+    if (deleteKeyInMap) deleteKeyInMap(keySlots[slot]);
+    eraseSlot(slot);
+    return removedValue;
+}
+
+template <class K, class V>
+bool SwissMap<K, V>::remove(const K &key, V value, void (*deleteKeyInMap)(K), void (*deleteValueInMap)(V))
+{
+    int slot = findSlot(key);
+    if (slot < 0 || !valueEQ(valueSlots[slot], value)) return false;
+
+    if (deleteKeyInMap != nullptr) deleteKeyInMap(keySlots[slot]);
+    if (deleteValueInMap != nullptr) deleteValueInMap(valueSlots[slot]);
+    eraseSlot(slot);
+    return true;
+}
+
+template <class K, class V>
+bool SwissMap<K, V>::containsKey(const K &key)
+{
+    return findSlot(key) >= 0;
+}
+
+template <class K, class V>
+bool SwissMap<K, V>::containsValue(V value)
+{
+    for (int slot = 0; slot < capacity; slot++) {
+        if (control[slot] >= 0 && valueEQ(valueSlots[slot], value)) return true;
+    }
+    return false;
+}
+
+template <class K, class V>
+bool SwissMap<K, V>::empty()
+{
+    return count == 0;
+}
+
+template <class K, class V>
+int SwissMap<K, V>::size()
+{
+    return count;
+}
+
+template <class K, class V>
+void SwissMap<K, V>::clear()
+{
+    removeInternalData();
+    allocate(groupWidth);
+}
+
+template <class K, class V>
+DLinkedList<K> SwissMap<K, V>::keys()
+{
+    DLinkedList<K> keyList;
+    for (int slot = 0; slot < capacity; slot++)
+        if (control[slot] >= 0) keyList.add(keySlots[slot]);
+    return keyList;
+}
+
+template <class K, class V>
+DLinkedList<V> SwissMap<K, V>::values()
+{
+    DLinkedList<V> valueList;
+    for (int slot = 0; slot < capacity; slot++)
+        if (control[slot] >= 0) valueList.add(valueSlots[slot]);
+    return valueList;
+}
+
+/*
+ * clashes(): one count per group, of the keys stored there whose probe
+ * started at another group (the open-addressing analogue of a chain's extra
+ * entries).
+ */
+template <class K, class V>
+DLinkedList<int> SwissMap<K, V>::clashes()
+{
+    DLinkedList<int> displacedList;
+    for (int group = 0; group < capacity / groupWidth; group++) {
+        int displaced = 0;
+        for (int slot = group * groupWidth; slot < (group + 1) * groupWidth; slot++) {
+            if (control[slot] >= 0 && homeGroup(keySlots[slot]) != group) displaced++;
+        }
+        displacedList.add(displaced);
+    }
+    return displacedList;
+}
+
+template <class K, class V>
+string SwissMap<K, V>::toString(string (*key2str)(K &), string (*value2str)(V &))
+{
+    stringstream os;
+    string mark(50, '=');
+    os << mark << endl;
+    os << setw(12) << left << "capacity: " << capacity << endl;
+    os << setw(12) << left << "size: " << count << endl;
+    for (int slot = 0; slot < capacity; slot++) {
+        if (control[slot] < 0) continue;
+        os << setw(4) << left << slot << ": (";
+        if (key2str != 0) os << key2str(keySlots[slot]);
+        else os << keySlots[slot];
+        os << ",";
+        if (value2str != 0) os << value2str(valueSlots[slot]);
+        else os << valueSlots[slot];
+        os << ")" << endl;
+    }
+    os << mark << endl;
+    return os.str();
+}
+
+template <class K, class V>
+void SwissMap<K, V>::reserve(int entries)
+{
+    int needed = groupWidth;
+    while (needed * loadFactor < entries) needed *= 2;
+    if (needed > capacity) rehash(needed);
+}
+
+////////////////////////////////////////////////////////
+//                  UTILITIES
+////////////////////////////////////////////////////////
+
+template <class K, class V>
+typename SwissMap<K, V>::Probe SwissMap<K, V>::startProbe(const K &key)
+{
+    // spread the callback's value over 64 bits: H2 from the top 7, H1 below them
+    Probe probe;
+    probe.hash = (unsigned long long)(unsigned int)hashCode(const_cast<K &>(key), INT_MAX) * 0x9E3779B97F4A7C15ULL;
+    probe.h2 = (signed char)(probe.hash >> 57);
+    probe.group = (int)(probe.hash >> 25) & (capacity / groupWidth - 1);
+    probe.step = 0;
+    return probe;
+}
+
+template <class K, class V>
+unsigned int SwissMap<K, V>::matchByte(int group, signed char byte) const
+{
+#ifdef SWISSMAP_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(control + group * groupWidth));
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(byte)));
+#else
+    unsigned int mask = 0;
+    const signed char *bytes = control + group * groupWidth;
+    for (int i = 0; i < groupWidth; i++)
+        if (bytes[i] == byte) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+template <class K, class V>
+unsigned int SwissMap<K, V>::matchFree(int group) const
+{
+    // EMPTY and DELETED are the only negative control bytes
+#ifdef SWISSMAP_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(control + group * groupWidth));
+    return (unsigned int)_mm_movemask_epi8(bytes);
+#else
+    unsigned int mask = 0;
+    const signed char *bytes = control + group * groupWidth;
+    for (int i = 0; i < groupWidth; i++)
+        if (bytes[i] < 0) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+template <class K, class V>
+int SwissMap<K, V>::lowestBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while ((mask & 1) == 0) { mask >>= 1; bit++; }
+    return bit;
+#endif
+}
+
+template <class K, class V>
+int SwissMap<K, V>::findSlot(const K &key)
+{
+    Probe probe = startProbe(key);
+    for (;;) {
+        for (unsigned int match = matchByte(probe.group, probe.h2); match != 0; match &= match - 1) {
+            int slot = probe.group * groupWidth + lowestBit(match);
+            if (keyEQ(keySlots[slot], const_cast<K &>(key))) return slot;
+        }
+        if (matchEmpty(probe.group) != 0) return -1;
+        nextGroup(probe);
+    }
+}
+
+/*
+ * eraseSlot: a group with an EMPTY slot never had a probe pass through it
+ * (the probe would have stopped, or inserted, there), so the slot can go
+ * straight back to EMPTY; otherwise it becomes a tombstone.
+ */
+template <class K, class V>
+void SwissMap<K, V>::eraseSlot(int slot)
+{
+    if (matchEmpty(slot / groupWidth) != 0) {
+        control[slot] = EMPTY;
+    } else {
+        control[slot] = DELETED;
+        tombstones++;
+    }
+    keySlots[slot] = K();
+    valueSlots[slot] = V();
+    count--;
+}
+
+template <class K, class V>
+void SwissMap<K, V>::ensureLoadFactor()
+{
+    if (count + tombstones + 1 <= (int)(loadFactor * capacity)) return;
+    // mostly tombstones: rebuilding at the same size reclaims them
+    rehash((count + 1 > (int)(loadFactor * capacity) / 2) ? capacity * 2 : capacity);
+}
+
+template <class K, class V>
+void SwissMap<K, V>::rehash(int newCapacity)
+{
+    signed char *oldControl = control;
+    K *oldKeys = keySlots;
+    V *oldValues = valueSlots;
+    int oldCapacity = capacity;
+
+    allocate(newCapacity);
+    for (int old = 0; old < oldCapacity; old++) {
+        if (oldControl[old] < 0) continue;
+        Probe probe = startProbe(oldKeys[old]);
+        unsigned int free = matchEmpty(probe.group);
+        while (free == 0) {
+            nextGroup(probe);
+            free = matchEmpty(probe.group);
+        }
+        int slot = probe.group * groupWidth + lowestBit(free);
+        control[slot] = probe.h2;
+        keySlots[slot] = oldKeys[old];
+        valueSlots[slot] = oldValues[old];
+        count++;
+    }
+
+    delete[] oldControl;
+    delete[] oldKeys;
+    delete[] oldValues;
+}
+
+template <class K, class V>
+void SwissMap<K, V>::allocate(int newCapacity)
+{
+    capacity = newCapacity;
+    count = 0;
+    tombstones = 0;
+    control = new signed char[capacity];
+    for (int slot = 0; slot < capacity; slot++) control[slot] = EMPTY;
+    keySlots = new K[capacity];
+    valueSlots = new V[capacity];
+}
+
+template <class K, class V>
+void SwissMap<K, V>::removeInternalData()
+{
+    if (deleteKeys != 0) deleteKeys(this);
+    if (deleteValues != 0) deleteValues(this);
+    delete[] control;
+    delete[] keySlots;
+    delete[] valueSlots;
+}
+
+template <class K, class V>
+void SwissMap<K, V>::copyMapFrom(const SwissMap<K, V> &map)
+{
+    this->hashCode = map.hashCode;
+    this->loadFactor = map.loadFactor;
+    this->valueEqual = map.valueEqual;
+    this->keyEqual = map.keyEqual;
+    // SHOULD NOT COPY: deleteKeys, deleteValues => delete ONLY TIME in map if needed
+    allocate(map.capacity);
+    for (int slot = 0; slot < map.capacity; slot++) {
+        if (map.control[slot] >= 0) put(map.keySlots[slot], map.valueSlots[slot]);
+    }
+}
+
+#endif /* SWISSMAP_H */
@@ -1,14 +1,21 @@
 #ifndef XMAP_H
 #define XMAP_H
 #include <memory.h>
+#include <climits>
+#include <cstdlib>
+#include <new>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <sstream>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
 using namespace std;
 
 #include "list/DLinkedList.h"
 #include "hash/IMap.h"
+#include "util/poolAllocator.h"
 
 /*
  * xMap<K, V>:
@@ -16,6 +23,30 @@ using namespace std;
  *  + V: value type
  *  For example:
  *      xMap<string, int>: map from string to int
+ *
+ * Hashing: each operation calls hashCode once, as hashCode(key, INT_MAX)
+ * (like SwissMap), and the entry keeps the result; its bucket is that hash
+ * modulo capacity, so a rehash never calls hashCode and buckets compare the
+ * stored hash before the key. For the usual f(key) % tableSize functions it
+ * is the same bucket as hashCode(key, capacity). Keys are taken by const
+ * reference (hashCode and keyEqual take K& but must not change the key).
+ *
+ * Incremental rehash (setIncrementalRehash): growth no longer moves every
+ * entry in the put that crosses the load factor. That put only switches to a
+ * new, larger table; the old one stays alive and each later put / get /
+ * remove / containsKey migrates a few of its buckets until it is empty.
+ * Lookups try the new table, then the key's old bucket if it has not been
+ * migrated yet. Buckets of the new table are constructed on first use and
+ * old buckets are destroyed as they are emptied, so no single operation pays
+ * for a whole table. Whole-map operations (keys, values, toString, clashes,
+ * containsValue, copies) see both tables or finish the migration first.
+ *
+ * Allocator (setAllocator): by default every put costs two heap blocks, the
+ * Entry and the bucket list's node, and every bucket two sentinel nodes. With
+ * a NodeAllocator all of them come from it instead; a PoolAllocator cuts an
+ * entry and its node from the same slab, side by side. If the map is the
+ * allocator's only user (exclusive), clear() and the destructor drop them all
+ * with one releaseAll(), running only the destructors of K and V, if any.
  */
 template <class K, class V>
 class xMap : public IMap<K, V>
@@ -25,6 +56,7 @@ public:
 
 protected:
     DLinkedList<Entry *> *table; // array of DLinkedList objects
+    unsigned char *tableReady;   // per bucket: constructed yet? nullptr when all are
     int capacity;                // size of table
     int count;                   // number of entries stored hash-map
     float loadFactor;            // define max number of entries can be stored (< (loadFactor * capacity))
@@ -35,6 +67,16 @@ protected:
     void (*deleteKeys)(xMap<K, V> *);   // deleteKeys(xMap<K,V>* pMap): delete all keys stored in pMap
     void (*deleteValues)(xMap<K, V> *); // deleteValues(xMap<K,V>* pMap): delete all values stored in pMap
 
+    // incremental rehash: while oldTable != nullptr, old buckets [migrated, oldCapacity) still hold entries
+    int rehashStep;                       // old buckets migrated per operation; 0: rehash all at once
+    DLinkedList<Entry *> *oldTable;
+    unsigned char *oldTableReady;
+    int oldCapacity;
+    int migrated;
+
+    NodeAllocator *allocator;             // entries and bucket nodes; nullptr: new / delete
+    bool exclusiveAllocator;              // no one else uses allocator: release it all at once
+
 public:
     xMap(
         int (*hashCode)(K &, int), // require
@@ -49,11 +91,11 @@ public:
     ~xMap();
 
     // Inherit from IMap:BEGIN
-    V put(K key, V value);
-    V &get(K key);
-    V remove(K key, void (*deleteKeyInMap)(K) = 0);
-    bool remove(K key, V value, void (*deleteKeyInMap)(K) = 0, void (*deleteValueInMap)(V) = 0);
-    bool containsKey(K key);
+    V put(const K &key, V value);
+    V &get(const K &key);
+    V remove(const K &key, void (*deleteKeyInMap)(K) = 0);
+    bool remove(const K &key, V value, void (*deleteKeyInMap)(K) = 0, void (*deleteValueInMap)(V) = 0);
+    bool containsKey(const K &key);
     bool containsValue(V value);
     bool empty();
     int size();
@@ -73,6 +115,81 @@ public:
     {
         return capacity;
     }
+    /*
+     * setIncrementalRehash(bucketsPerStep): migrate bucketsPerStep old buckets
+     * per operation after a growth instead of all at once; 0 turns it off
+     * (finishing any migration in progress). With puts alone, a step of at
+     * least 2 / loadFactor (3 at 0.75) ends each migration before the next
+     * growth is due; otherwise that growth finishes it in one go.
+     */
+    void setIncrementalRehash(int bucketsPerStep = 8)
+    {
+        if (bucketsPerStep <= 0) finishRehash();
+        rehashStep = (bucketsPerStep > 0) ? bucketsPerStep : 0;
+    }
+    bool rehashing()
+    {
+        return oldTable != nullptr;
+    }
+    /*
+     * setAllocator(allocator, exclusive): take entries and bucket nodes from
+     * allocator (nullptr: back to new / delete). The map must be empty, else
+     * std::logic_error; it does not own allocator, which must outlive it.
+     * exclusive promises that nothing else allocates from it, so clearing the
+     * map may call allocator->releaseAll(). Copies of the map do not share it.
+     */
+    void setAllocator(NodeAllocator *allocator, bool exclusive = false)
+    {
+        finishRehash();
+        if (count != 0)
+            throw std::logic_error("setAllocator: the map is not empty");
+        releaseTable(table, tableReady, capacity);
+        this->allocator = allocator;
+        this->exclusiveAllocator = exclusive && allocator != nullptr;
+        this->table = allocateTable(capacity, false, this->tableReady);
+    }
+    /*
+     * Lookups that hand back the Entry, so a check followed by a read or an
+     * update, or a get-or-insert, costs one hash and one probe:
+     *  + hashOf(key): hashCode(key, INT_MAX), the hash entries keep
+     *  + find(key): the entry holding key, or nullptr
+     *  + findOrPut(key, value, inserted): the entry holding key, after adding
+     *      key -> value if there was none (*inserted says which)
+     * The (hash, probe) forms skip hashCode: hash must be what hashOf gives
+     * for the key probe stands for, and entries match when key == probe, so a
+     * string_view can look up string keys (with stringViewHash standing in for
+     * stringKeyHash); findOrPut builds K(probe) only when it inserts.
+     * An Entry stays valid until its key is removed or the map is cleared.
+     */
+    int hashOf(const K &key)
+    {
+        return hashCode(const_cast<K &>(key), INT_MAX);
+    }
+    Entry *find(const K &key)
+    {
+        return find(hashOf(key), key);
+    }
+    template <class Probe>
+    Entry *find(int hash, const Probe &probe)
+    {
+        if (oldTable != nullptr) migrateBuckets(rehashStep);
+        DLinkedList<Entry *> *bucket;
+        return findEntry(hash, probe, bucket);
+    }
+    Entry *findOrPut(const K &key, V value, bool *inserted = nullptr)
+    {
+        return findOrPut(hashOf(key), key, value, inserted);
+    }
+    template <class Probe>
+    Entry *findOrPut(int hash, const Probe &probe, V value, bool *inserted = nullptr)
+    {
+        if (oldTable != nullptr) migrateBuckets(rehashStep);
+        DLinkedList<Entry *> *bucket;
+        Entry *current = findEntry(hash, probe, bucket);
+        if (inserted != nullptr) *inserted = (current == nullptr);
+        if (current != nullptr) return current;
+        return addEntry(asKey(probe), value, hash);
+    }
  
    ///////////////////////////////////////////////////
    // STATIC METHODS: BEGIN
@@ -89,10 +206,14 @@ public:
         return key % capacity;
     }
     static int stringKeyHash(string &key, int capacity)
+    {
+        return stringViewHash(key, capacity);
+    }
+    static int stringViewHash(string_view key, int capacity)
     {
         long long int sum = 0;
-        for (int idx = 0; idx < key.length(); idx++)
-            sum += key[idx];
+        for (char c : key)
+            sum += c;
         return sum % capacity;
     }
     /*
@@ -104,14 +225,7 @@ public:
      */
     static void freeKey(xMap<K, V> *pMap)
     {
-        for (int idx = 0; idx < pMap->capacity; idx++)
-        {
-            DLinkedList<Entry *> list = pMap->table[idx];
-            for (auto pEntry : list)
-            {
-                delete pEntry->key;
-            }
-        }
+        pMap->forEachEntry([](Entry *pEntry) { delete pEntry->key; });
     }
    /*
     * freeValue(xMap<K,V> *pMap):
@@ -121,12 +235,7 @@ public:
     *      2. Users need xMap to free values
     */
    static void freeValue(xMap<K, V>* pMap) {
-     for (int idx = 0; idx < pMap->capacity; idx++) {
-       DLinkedList<Entry*> list = pMap->table[idx];
-       for (auto pEntry : list) {
-         delete pEntry->value;
-       }
-     }
+     pMap->forEachEntry([](Entry* pEntry) { delete pEntry->value; });
    }
    /*
     * deleteEntry(Entry* ptr): a function pointer to delete pointer to Entry
@@ -149,6 +258,89 @@ public:
    void copyMapFrom(const xMap<K, V>& map);
    void moveEntries(DLinkedList<Entry*>* oldTable, int oldCapacity,
                     DLinkedList<Entry*>* newTable, int newCapacity);
+
+   // tables are raw storage of capacity buckets; with lazy, a bucket is
+   // constructed by bucketAt on first use and *ready flags which ones are
+   DLinkedList<Entry*>* allocateTable(int capacity, bool lazy, unsigned char*& ready);
+   void releaseTable(DLinkedList<Entry*>* table, unsigned char* ready, int capacity);
+   DLinkedList<Entry*>& bucketAt(DLinkedList<Entry*>* table, unsigned char* ready, int idx) {
+     if (ready != nullptr && !ready[idx]) {
+       new (&table[idx]) DLinkedList<Entry*>(0, 0, allocator);
+       ready[idx] = 1;
+     }
+     return table[idx];
+   }
+   static DLinkedList<Entry*>* bucketIfReady(DLinkedList<Entry*>* table, unsigned char* ready, int idx) {
+     return (ready == nullptr || ready[idx]) ? &table[idx] : nullptr;
+   }
+
+   // entries come from allocator when it can align them
+   static constexpr bool poolableEntry() { return alignof(Entry) <= NodeAllocator::alignment; }
+   Entry* createEntry(const K& key, const V& value, int hash) {
+     if (allocator == nullptr || !poolableEntry()) return new Entry(key, value, hash);
+     return new (allocator->allocate(sizeof(Entry))) Entry(key, value, hash);
+   }
+   void destroyEntry(Entry* pEntry) {
+     if (allocator == nullptr || !poolableEntry()) {
+       delete pEntry;
+     } else {
+       pEntry->~Entry();
+       allocator->release(pEntry, sizeof(Entry));
+     }
+   }
+
+   // incremental rehash
+   void startRehash(int newCapacity);
+   void migrateBuckets(int buckets);
+   void finishRehash() { if (oldTable != nullptr) migrateBuckets(oldCapacity); }
+   static int bucketIndex(int hash, int capacity) {
+     return (int)((unsigned int)hash % (unsigned int)capacity);
+   }
+   // matches: keyEqual for a K, operator== for any other probe
+   bool matches(Entry* pEntry, const K& key) { return keyEQ(pEntry->key, const_cast<K&>(key)); }
+   template <class Probe>
+   bool matches(Entry* pEntry, const Probe& probe) { return pEntry->key == probe; }
+   static const K& asKey(const K& key) { return key; }
+   template <class Probe>
+   static K asKey(const Probe& probe) { return K(probe); }
+
+   // findEntry: the entry holding key (and the bucket it is in), or nullptr
+   template <class Probe>
+   Entry* findEntry(int hash, const Probe& key, DLinkedList<Entry*>*& bucket) {
+     bucket = bucketIfReady(table, tableReady, bucketIndex(hash, capacity));
+     if (bucket != nullptr) {
+       for (auto current : *bucket)
+         if (current->hash == hash && matches(current, key)) return current;
+     }
+     if (oldTable == nullptr) return nullptr;
+
+     // not migrated yet: the key may still sit in its old bucket
+     int oldIdx = bucketIndex(hash, oldCapacity);
+     bucket = (oldIdx >= migrated) ? bucketIfReady(oldTable, oldTableReady, oldIdx) : nullptr;
+     if (bucket != nullptr) {
+       for (auto current : *bucket)
+         if (current->hash == hash && matches(current, key)) return current;
+     }
+     return nullptr;
+   }
+   // addEntry: add key -> value, known to be absent, to its bucket
+   Entry* addEntry(const K& key, const V& value, int hash);
+
+   // forEachEntry(visit): visit(Entry*) for every entry, in both tables
+   template <class Visit>
+   void forEachEntry(Visit visit) const {
+     for (int idx = 0; idx < capacity; idx++) {
+       DLinkedList<Entry*>* list = bucketIfReady(table, tableReady, idx);
+       if (list != nullptr)
+         for (auto pEntry : *list) visit(pEntry);
+     }
+     if (oldTable == nullptr) return;
+     for (int idx = migrated; idx < oldCapacity; idx++) {
+       DLinkedList<Entry*>* list = bucketIfReady(oldTable, oldTableReady, idx);
+       if (list != nullptr)
+         for (auto pEntry : *list) visit(pEntry);
+     }
+   }
  
    /*
     * keyEQ(K& lhs, K& rhs): verify the equality of two keys
@@ -178,13 +370,13 @@ public:
     private:
      K key;
      V value;
+     int hash;  // hashOf(key)
      friend class xMap<K, V>;
  
     public:
-     Entry(K key, V value) {
-       this->key = key;
-       this->value = value;
-     }
+     Entry(const K& key, const V& value, int hash = 0) : key(key), value(value), hash(hash) {}
+     const K& getKey() const { return key; }
+     V& getValue() { return value; }
    };
    // Entry: END
  };
@@ -211,12 +403,20 @@ xMap<K, V>::xMap(
    this->keyEqual = keyEqual;
    this->deleteKeys = deleteKeys;
    this->deleteValues = deleteValues;
-   this->table = new DLinkedList<Entry*>[capacity];
+   this->rehashStep = 0;
+   this->oldTable = nullptr;
+   this->allocator = nullptr;
+   this->exclusiveAllocator = false;
+   this->table = allocateTable(capacity, false, this->tableReady);
  }
  
  template <class K, class V>
  xMap<K, V>::xMap(const xMap<K, V>& map) {
    // Copy data from the input map
+   this->rehashStep = map.rehashStep;
+   this->oldTable = nullptr;
+   this->allocator = nullptr;
+   this->exclusiveAllocator = false;
    copyMapFrom(map);
 
    this->deleteKeys = nullptr;  
@@ -242,22 +442,27 @@ xMap<K, V>::xMap(
  //////////////////////////////////////////////////////////////////////
  
  template <class K, class V>
- V xMap<K, V>::put(K key, V value) {
-    int bucketIdx = hashCode(key, capacity);
-    DLinkedList<Entry *> &bucket = table[bucketIdx];
-
-    typename DLinkedList<Entry *>::Iterator it = bucket.begin();
-    while (it != bucket.end()) {
-        Entry *current = *it;
-        if (keyEQ(current->key, key)) {
-            V previousValue = current->value;
-            current->value = value;
-            return previousValue;
-        }
-        ++it;
+ V xMap<K, V>::put(const K& key, V value) {
+    if (oldTable != nullptr) migrateBuckets(rehashStep);
+
+    int hash = hashOf(key);
+    DLinkedList<Entry *> *found;
+    Entry *current = findEntry(hash, key, found);
+    if (current != nullptr) {
+        V previousValue = current->value;
+        current->value = value;
+        return previousValue;
     }
 
-    Entry *entry = new Entry(key, value);
+    addEntry(key, value, hash);
+    return value;
+}
+
+ template <class K, class V>
+ typename xMap<K, V>::Entry *xMap<K, V>::addEntry(const K &key, const V &value, int hash) {
+    int bucketIdx = bucketIndex(hash, capacity);
+    DLinkedList<Entry *> &bucket = bucketAt(table, tableReady, bucketIdx);
+    Entry *entry = createEntry(key, value, hash);
     bucket.add(entry);
     count++;
 
@@ -265,21 +470,17 @@ xMap<K, V>::xMap(
         list_clashes.add(bucketIdx);
     }
     ensureLoadFactor(count);
-    return value;
+    return entry;
 }
  
  template <class K, class V>
- V& xMap<K, V>::get(K key) {
-    int bucketIdx = hashCode(key, capacity);
-    DLinkedList<Entry *> &bucket = table[bucketIdx];
-
-    auto iter = bucket.begin();
-    while (iter != bucket.end()) {
-        Entry *current = *iter;
-        if (keyEQ(current->key, key)) {
-            return current->value; 
-        }
-        ++iter;
+ V& xMap<K, V>::get(const K& key) {
+    if (oldTable != nullptr) migrateBuckets(rehashStep);
+
+    DLinkedList<Entry *> *bucket;
+    Entry *current = findEntry(hashOf(key), key, bucket);
+    if (current != nullptr) {
+        return current->value;
     }
 
    // key: not found
@@ -289,26 +490,23 @@ xMap<K, V>::xMap(
  }
  
  template <class K, class V>
- V xMap<K, V>::remove(K key, void (*deleteKeyInMap)(K)) {
-    int bucketIdx = hashCode(key, capacity);
-    DLinkedList<Entry *> &bucket = table[bucketIdx];
-
-    auto iter = bucket.begin();
-    while (iter != bucket.end()) {
-        Entry *current = *iter;
-        if (keyEQ(current->key, key)) {
-            // Store value to return
-            V removedValue = current->value;
-
-            if (deleteKeyInMap) {
-                deleteKeyInMap(current->key);
-            }
-
-            bucket.removeItem(current, &xMap<K, V>::deleteEntry);
-            count--;
-            return removedValue;
+ V xMap<K, V>::remove(const K& key, void (*deleteKeyInMap)(K)) {
+    if (oldTable != nullptr) migrateBuckets(rehashStep);
+
+    DLinkedList<Entry *> *bucket;
+    Entry *current = findEntry(hashOf(key), key, bucket);
+    if (current != nullptr) {
+        // Store value to return
+        V removedValue = current->value;
+
+        if (deleteKeyInMap) {
+            deleteKeyInMap(current->key);
         }
-        ++iter;
+
+        bucket->removeItem(current);
+        destroyEntry(current);
+        count--;
+        return removedValue;
     }
 
    // key: not found
@@ -318,27 +516,24 @@ xMap<K, V>::xMap(
  }
  
  template <class K, class V>
- bool xMap<K, V>::remove(K key, V value, void (*deleteKeyInMap)(K),
+ bool xMap<K, V>::remove(const K& key, V value, void (*deleteKeyInMap)(K),
                          void (*deleteValueInMap)(V)) {
-    int bucketIdx = hashCode(key, capacity);
-    DLinkedList<Entry *> &bucket = table[bucketIdx];
-
-    auto iter = bucket.begin();
-    while (iter != bucket.end()) {
-        Entry *current = *iter;
-        if (keyEQ(current->key, key) && valueEQ(current->value, value)) {
-            if (deleteKeyInMap != nullptr) {
-                deleteKeyInMap(current->key);
-            }
-            if (deleteValueInMap != nullptr) {
-                deleteValueInMap(current->value);
-            }
-
-            bucket.removeItem(current, &xMap<K, V>::deleteEntry);
-            count--;
-            return true;
+    if (oldTable != nullptr) migrateBuckets(rehashStep);
+
+    DLinkedList<Entry *> *bucket;
+    Entry *current = findEntry(hashOf(key), key, bucket);
+    if (current != nullptr && valueEQ(current->value, value)) {
+        if (deleteKeyInMap != nullptr) {
+            deleteKeyInMap(current->key);
+        }
+        if (deleteValueInMap != nullptr) {
+            deleteValueInMap(current->value);
         }
-        ++iter;
+
+        bucket->removeItem(current);
+        destroyEntry(current);
+        count--;
+        return true;
     }
 
     // key: not found
@@ -348,39 +543,20 @@ xMap<K, V>::xMap(
  }
  
  template <class K, class V>
- bool xMap<K, V>::containsKey(K key) {
-    int bucketIdx = hashCode(key, capacity);
-    DLinkedList<Entry *> &bucket = table[bucketIdx];
-
-    auto iter = bucket.begin();
-    while (iter != bucket.end()) {
-        Entry *current = *iter;
-        if (keyEQ(current->key, key)) {
-            return true;
-        }
-        ++iter;
-    }
+ bool xMap<K, V>::containsKey(const K& key) {
+    if (oldTable != nullptr) migrateBuckets(rehashStep);
 
-    // Key not found
-    return false;
+    DLinkedList<Entry *> *bucket;
+    return findEntry(hashOf(key), key, bucket) != nullptr;
  }
  
  template <class K, class V>
  bool xMap<K, V>::containsValue(V value) {
-    int index = hashCode(key, capacity);
-    for (int bucketIndex = 0; bucketIndex < capacity; bucketIndex++) {
-        DLinkedList<Entry *> &bucket = table[bucketIndex];
-
-        auto iter = bucket.begin();
-        while (iter != bucket.end()) {
-            Entry *current = *iter;
-            if (valueEQ(current->value, value)) {
-                return true;
-            }
-            ++iter;
-        }
-    }
-    return false;
+    bool found = false;
+    forEachEntry([&](Entry *current) {
+        if (!found && valueEQ(current->value, value)) found = true;
+    });
+    return found;
  }
 
  template <class K, class V>
@@ -397,37 +573,21 @@ xMap<K, V>::xMap(
  void xMap<K, V>::clear() {
     removeInternalData();
     this->capacity = 10;
-    this->table = new DLinkedList<Entry *>[capacity];
+    this->table = allocateTable(capacity, false, this->tableReady);
     this->count = 0;
 }
  
  template <class K, class V>
  DLinkedList<K> xMap<K, V>::keys() {
     DLinkedList<K> keyList;
-    for (int bucketIndex = 0; bucketIndex < capacity; bucketIndex++) {
-        DLinkedList<Entry *> &bucket = table[bucketIndex];
-        auto iter = bucket.begin();
-        while (iter != bucket.end()) {
-            Entry *current = *iter;
-            keyList.add(current->key);
-            ++iter;
-        }
-    }
+    forEachEntry([&](Entry *current) { keyList.add(current->key); });
     return keyList;
  }
  
  template <class K, class V>
  DLinkedList<V> xMap<K, V>::values() {
     DLinkedList<V> valueList;
-    for (int bucketIndex = 0; bucketIndex < capacity; bucketIndex++) {
-        DLinkedList<Entry *> &bucket = table[bucketIndex];
-        auto iter = bucket.begin();
-        while (iter != bucket.end()) {
-            Entry *current = *iter;
-            valueList.add(current->value);
-            ++iter;
-        }
-    }
+    forEachEntry([&](Entry *current) { valueList.add(current->value); });
     return valueList;
  }
  
@@ -435,9 +595,10 @@ xMap<K, V>::xMap(
  DLinkedList<int> xMap<K, V>::clashes() {
     DLinkedList<int> sizeList;
 
+    finishRehash();
     for (int bucketIndex = 0; bucketIndex < capacity; bucketIndex++) {
-        DLinkedList<Entry *> &bucket = table[bucketIndex];
-        sizeList.add(bucket.size());
+        DLinkedList<Entry *> *bucket = bucketIfReady(table, tableReady, bucketIndex);
+        sizeList.add(bucket != nullptr ? bucket->size() : 0);
     }
 
     return sizeList;
@@ -447,12 +608,13 @@ xMap<K, V>::xMap(
  string xMap<K, V>::toString(string (*key2str)(K&), string (*value2str)(V&)) {
    stringstream os;
     string mark(50, '=');
+    finishRehash();
     os << mark << endl;
     os << setw(12) << left << "capacity: " << capacity << endl;
     os << setw(12) << left << "size: " << count << endl;
     for (int idx = 0; idx < capacity; idx++)
     {
-        DLinkedList<Entry *> list = table[idx];
+        DLinkedList<Entry *> &list = bucketAt(table, tableReady, idx);
 
         os << setw(4) << left << idx << ": ";
         stringstream itemos;
@@ -499,10 +661,11 @@ void xMap<K, V>::moveEntries(
 {
     for (int old_index = 0; old_index < oldCapacity; old_index++)
     {
-        DLinkedList<Entry *> &oldList = oldTable[old_index];
-        for (auto oldEntry : oldList)
+        DLinkedList<Entry *> *oldList = bucketIfReady(oldTable, this->tableReady, old_index);
+        if (oldList == nullptr) continue;
+        for (auto oldEntry : *oldList)
         {
-            int new_index = this->hashCode(oldEntry->key, newCapacity);
+            int new_index = bucketIndex(oldEntry->hash, newCapacity);
             DLinkedList<Entry *> &newList = newTable[new_index];
             newList.add(oldEntry);
         }
@@ -522,9 +685,12 @@ void xMap<K, V>::moveEntries(
     // cout << "ensureLoadFactor: count = " << count << "; maxSize = " << maxSize << endl;
     if (current_size > maxSize)
     {
-        int oldCapacity = capacity;
-        int newCapacity = (oldCapacity < 1) ? 10 : (int)(oldCapacity * 1.5);
-        rehash(newCapacity);
+        int currentCapacity = capacity;
+        int newCapacity = (currentCapacity < 1) ? 10 : (int)(currentCapacity * 1.5);
+        if (rehashStep > 0)
+            startRehash(newCapacity);
+        else
+            rehash(newCapacity);
     }
  }
  
@@ -537,23 +703,90 @@ void xMap<K, V>::moveEntries(
   */
  template <class K, class V>
  void xMap<K, V>::rehash(int newCapacity) {
+   finishRehash();
    DLinkedList<Entry *> *pOldMap = this->table;
-    int oldCapacity = capacity;
+    unsigned char *pOldReady = this->tableReady;
+    int currentCapacity = capacity;
 
     // Create new table:
-    this->table = new DLinkedList<Entry *>[newCapacity];
+    unsigned char *newReady;
+    DLinkedList<Entry *> *newTable = allocateTable(newCapacity, false, newReady);
+
+    moveEntries(pOldMap, currentCapacity, newTable, newCapacity);
+
+    // Remove oldTable: only remove nodes in list, no entry
+    releaseTable(pOldMap, pOldReady, currentCapacity);
+    this->table = newTable;
+    this->tableReady = newReady;
     this->capacity = newCapacity; // keep "count" not changed
+ }
 
-    moveEntries(pOldMap, oldCapacity, this->table, newCapacity);
+ /*
+  * startRehash(int newCapacity)
+  *  Purpose (incremental mode): make a new, lazily constructed table the
+  *  current one and keep the old table for migrateBuckets to empty.
+  */
+ template <class K, class V>
+ void xMap<K, V>::startRehash(int newCapacity) {
+    finishRehash();
+    this->oldTable = this->table;
+    this->oldTableReady = this->tableReady;
+    this->oldCapacity = this->capacity;
+    this->migrated = 0;
+
+    this->table = allocateTable(newCapacity, true, this->tableReady);
+    this->capacity = newCapacity;
+ }
 
-    // remove old data: only remove nodes in list, no entry
-    for (int idx = 0; idx < oldCapacity; idx++)
-    {
-        DLinkedList<Entry *> &list = pOldMap[idx];
-        list.clear();
+ /*
+  * migrateBuckets(int buckets)
+  *  Purpose: move the entries of the next `buckets` old buckets to the
+  *  current table and destroy those buckets; free the old table once every
+  *  bucket is moved.
+  */
+ template <class K, class V>
+ void xMap<K, V>::migrateBuckets(int buckets) {
+    for (; buckets > 0 && migrated < oldCapacity; buckets--, migrated++) {
+        DLinkedList<Entry *> *oldList = bucketIfReady(oldTable, oldTableReady, migrated);
+        if (oldList == nullptr) continue;
+        for (auto oldEntry : *oldList) {
+            int new_index = bucketIndex(oldEntry->hash, capacity);
+            bucketAt(table, tableReady, new_index).add(oldEntry);
+        }
+        oldList->~DLinkedList();
+    }
+    if (migrated == oldCapacity) {
+        free(oldTable);
+        oldTable = nullptr;
     }
-    // Remove oldTable
-    delete[] pOldMap;
+ }
+
+ template <class K, class V>
+ DLinkedList<typename xMap<K, V>::Entry *> *xMap<K, V>::allocateTable(int capacity, bool lazy, unsigned char *&ready) {
+    // one raw block: the buckets, then (lazy) one ready flag per bucket. A
+    // large block is fresh, already zeroed memory from the OS, so calloc
+    // touches nothing up front and the release is a single unmap
+    size_t bytes = sizeof(DLinkedList<Entry *>) * capacity;
+    void *block = lazy ? calloc(bytes + capacity, 1) : malloc(bytes);
+    if (block == nullptr) throw std::bad_alloc();
+
+    DLinkedList<Entry *> *table = static_cast<DLinkedList<Entry *> *>(block);
+    if (lazy) {
+        ready = static_cast<unsigned char *>(block) + bytes;
+    } else {
+        ready = nullptr;
+        for (int idx = 0; idx < capacity; idx++) new (&table[idx]) DLinkedList<Entry *>(0, 0, allocator);
+    }
+    return table;
+ }
+
+ template <class K, class V>
+ void xMap<K, V>::releaseTable(DLinkedList<Entry *> *table, unsigned char *ready, int capacity) {
+    for (int idx = 0; idx < capacity; idx++) {
+        DLinkedList<Entry *> *list = bucketIfReady(table, ready, idx);
+        if (list != nullptr) list->~DLinkedList();
+    }
+    free(table);
  }
  
  /*
@@ -572,17 +805,33 @@ void xMap<K, V>::moveEntries(
     if (deleteValues != 0)
         deleteValues(this);
 
-    // Remove all entries in the current map
-    for (int idx = 0; idx < this->capacity; idx++)
-    {
-        DLinkedList<Entry *> &list = this->table[idx];
-        for (auto pEntry : list)
-            delete pEntry;
-        list.clear();
+    if (exclusiveAllocator) {
+        // entries and nodes go back with the allocator's memory: only K and V
+        // may need destructors, and the buckets hold nothing else
+        if (!poolableEntry())
+            forEachEntry([](Entry *pEntry) { delete pEntry; });
+        else if (!std::is_trivially_destructible<Entry>::value)
+            forEachEntry([](Entry *pEntry) { pEntry->~Entry(); });
+        free(table);
+        if (oldTable != nullptr) free(oldTable);
+        oldTable = nullptr;
+        allocator->releaseAll();
+        return;
     }
 
-    // Remove table
-    delete[] table;
+    // Remove all entries in the current map
+    forEachEntry([this](Entry *pEntry) { destroyEntry(pEntry); });
+
+    // Remove tables (the old one: only the buckets not migrated are left)
+    releaseTable(table, tableReady, capacity);
+    if (oldTable != nullptr) {
+        for (int idx = migrated; idx < oldCapacity; idx++) {
+            DLinkedList<Entry *> *list = bucketIfReady(oldTable, oldTableReady, idx);
+            if (list != nullptr) list->~DLinkedList();
+        }
+        free(oldTable);
+        oldTable = nullptr;
+    }
  }
  
  /*
@@ -597,7 +846,7 @@ void xMap<K, V>::moveEntries(
  void xMap<K, V>::copyMapFrom(const xMap<K, V>& map) {
     this->capacity = map.capacity;
     this->count = 0;
-    this->table = new DLinkedList<Entry *>[capacity];
+    this->table = allocateTable(capacity, false, this->tableReady);
 
     this->hashCode = map.hashCode;
     this->loadFactor = map.loadFactor;
@@ -606,15 +855,8 @@ void xMap<K, V>::moveEntries(
     this->keyEqual = map.keyEqual;
     // SHOULD NOT COPY: deleteKeys, deleteValues => delete ONLY TIME in map if needed
 
-    // copy entries
-    for (int idx = 0; idx < map.capacity; idx++)
-    {
-        DLinkedList<Entry *> &list = map.table[idx];
-        for (auto pEntry : list)
-        {
-        this->put(pEntry->key, pEntry->value);
-        }
-    }
+    // copy entries (keys are distinct and their hashes known)
+    map.forEachEntry([this](Entry *pEntry) { this->addEntry(pEntry->key, pEntry->value, pEntry->hash); });
 }
 
  
@@ -0,0 +1,254 @@
+#ifndef ADAPTIVE_HUFFMAN_H
+#define ADAPTIVE_HUFFMAN_H
+
+#include <string>
+
+/*
+ * AdaptiveHuffmanTree<treeOrder>: one-pass (dynamic) N-ary Huffman coding,
+ * the FGK algorithm generalised from binary to treeOrder-ary trees.
+ *
+ * Encoder and decoder each keep a model that starts empty and is updated
+ * after every symbol, so no codebook is ever sent; both sides stay in step as
+ * long as the decoder sees exactly the symbols the encoder coded, in order.
+ *
+ * Sibling property: every node carries a number, the root the highest, and
+ * weights never decrease with the number; the treeOrder children of a node
+ * hold consecutive numbers. Counting a symbol walks from its leaf to the root:
+ * each node first trades places (with its subtree) with the highest-numbered
+ * node of the same weight that is not one of its ancestors, then has its
+ * weight incremented, which keeps the property and hence the code optimal.
+ *
+ * Unseen symbols: zero-weight "empty" leaves sit at the lowest numbers, and
+ * the lowest of them is the escape. A new symbol is coded as the escape's code
+ * followed by the byte in rawDigits base-treeOrder digits; it then takes over
+ * the escape leaf. When only one empty leaf is left, it is first split into
+ * treeOrder empty leaves.
+ *
+ * Digits are written and read as text ('0'-'9', 'a'-'f'), like encodeHuffman.
+ */
+template <int treeOrder>
+class AdaptiveHuffmanTree {
+public:
+    static_assert(treeOrder >= 2 && treeOrder <= 16, "treeOrder must be in [2, 16]");
+
+    // digits of a raw (escaped) byte: the smallest k with treeOrder^k >= 256
+    static constexpr int rawDigits = (treeOrder == 2) ? 8 : (treeOrder == 3) ? 6 : (treeOrder <= 6) ? 4
+                                   : (treeOrder <= 15) ? 3 : 2;
+
+    AdaptiveHuffmanTree() { reset(); }
+
+    // Forget every symbol: back to the empty model both sides start from.
+    void reset();
+
+    // Append the code of symbol to digits, then count it.
+    void encode(char symbol, std::string& digits);
+
+    /*
+     * decode(digit, end): read one symbol's code from [digit, end), advancing
+     * digit, and count the symbol. Returns the symbol as 0..255, or -1 when the
+     * digits run out mid-code or are not a code of this model; the model must
+     * then be reset on both sides.
+     */
+    int decode(const char*& digit, const char* end);
+
+    // Number of distinct symbols seen so far.
+    int symbols() const { return symbolCount; }
+
+private:
+    enum { INTERNAL = -1, EMPTY = -2 };
+
+    struct Node {
+        int weight;
+        int number;
+        int parent;      // node id, -1 for the root
+        int childIndex;  // position among the parent's children
+        int symbol;      // 0..255, INTERNAL or EMPTY
+        int children[treeOrder];
+    };
+
+    // enough for 256 symbols plus the escape: each split adds treeOrder - 1 leaves
+    static constexpr int maxSplits = 256 / (treeOrder - 1) + 2;
+    static constexpr int capacity = 1 + treeOrder * maxSplits;
+
+    Node nodes[capacity];
+    int nodeAt[capacity];   // node id by number
+    int leafOf[256];        // node id by symbol, -1 until seen
+    int nodeCount;
+    int lowest;             // lowest number in use; nodeAt[lowest] is the escape
+    int emptyCount;
+    int symbolCount;
+
+    static char digitChar(int digit) { return (char)(digit < 10 ? '0' + digit : 'a' + digit - 10); }
+    static int digitValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+    void appendCode(int node, std::string& digits);
+    int assignEscape(int symbol);
+    void split(int node);
+    void swapNodes(int a, int b);
+    bool isAncestor(int ancestor, int node) const;
+    void update(int node);
+};
+
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::reset()
+{
+    for (int c = 0; c < 256; ++c) leafOf[c] = -1;
+    nodeCount = 1;
+    lowest = capacity - 1;
+    emptyCount = 1;
+    symbolCount = 0;
+
+    Node& root = nodes[0];
+    root.weight = 0;
+    root.number = lowest;
+    root.parent = -1;
+    root.childIndex = 0;
+    root.symbol = EMPTY;
+    nodeAt[lowest] = 0;
+}
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::encode(char symbol, std::string &digits)
+{
+    int leaf = leafOf[(unsigned char)symbol];
+    if (leaf < 0) {
+        appendCode(nodeAt[lowest], digits);
+        int value = (unsigned char)symbol;
+        char raw[rawDigits];
+        for (int i = rawDigits - 1; i >= 0; --i, value /= treeOrder) raw[i] = digitChar(value % treeOrder);
+        digits.append(raw, rawDigits);
+        leaf = assignEscape((unsigned char)symbol);
+    } else {
+        appendCode(leaf, digits);
+    }
+    update(leaf);
+}
+
+template <int treeOrder>
+int AdaptiveHuffmanTree<treeOrder>::decode(const char *&digit, const char *end)
+{
+    int node = 0;
+    while (nodes[node].symbol == INTERNAL) {
+        if (digit == end) return -1;
+        int value = digitValue(*digit++);
+        if (value < 0 || value >= treeOrder) return -1;
+        node = nodes[node].children[value];
+    }
+
+    if (nodes[node].symbol == EMPTY) {
+        // only the escape is a valid code among the empty leaves
+        if (node != nodeAt[lowest] || end - digit < rawDigits) return -1;
+        int symbol = 0;
+        for (int i = 0; i < rawDigits; ++i) {
+            int value = digitValue(*digit++);
+            if (value < 0 || value >= treeOrder) return -1;
+            symbol = symbol * treeOrder + value;
+        }
+        if (symbol > 255 || leafOf[symbol] >= 0) return -1;
+        node = assignEscape(symbol);
+    }
+
+    int symbol = nodes[node].symbol;
+    update(node);
+    return symbol;
+}
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::appendCode(int node, std::string &digits)
+{
+    char path[capacity];
+    int length = 0;
+    for (; nodes[node].parent >= 0; node = nodes[node].parent) {
+        path[length++] = digitChar(nodes[node].childIndex);
+    }
+    while (length > 0) digits.push_back(path[--length]);
+}
+
+template <int treeOrder>
+int AdaptiveHuffmanTree<treeOrder>::assignEscape(int symbol)
+{
+    if (emptyCount == 1) split(nodeAt[lowest]);
+    int leaf = nodeAt[lowest];
+    nodes[leaf].symbol = symbol;
+    leafOf[symbol] = leaf;
+    --emptyCount;
+    ++symbolCount;
+    return leaf;
+}
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::split(int node)
+{
+    nodes[node].symbol = INTERNAL;
+    for (int i = 0; i < treeOrder; ++i) {
+        int child = nodeCount++;
+        Node& leaf = nodes[child];
+        leaf.weight = 0;
+        leaf.number = --lowest;
+        leaf.parent = node;
+        leaf.childIndex = i;
+        leaf.symbol = EMPTY;
+        nodes[node].children[i] = child;
+        nodeAt[lowest] = child;
+    }
+    emptyCount += treeOrder - 1;
+}
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::swapNodes(int a, int b)
+{
+    Node& nodeA = nodes[a];
+    Node& nodeB = nodes[b];
+    nodes[nodeA.parent].children[nodeA.childIndex] = b;
+    nodes[nodeB.parent].children[nodeB.childIndex] = a;
+
+    int parent = nodeA.parent, childIndex = nodeA.childIndex, number = nodeA.number;
+    nodeA.parent = nodeB.parent;
+    nodeA.childIndex = nodeB.childIndex;
+    nodeA.number = nodeB.number;
+    nodeB.parent = parent;
+    nodeB.childIndex = childIndex;
+    nodeB.number = number;
+    nodeAt[nodeA.number] = a;
+    nodeAt[nodeB.number] = b;
+}
+
+template <int treeOrder>
+bool AdaptiveHuffmanTree<treeOrder>::isAncestor(int ancestor, int node) const
+{
+    for (node = nodes[node].parent; node >= 0; node = nodes[node].parent) {
+        if (node == ancestor) return true;
+    }
+    return false;
+}
+
+template <int treeOrder>
+void AdaptiveHuffmanTree<treeOrder>::update(int node)
+{
+    while (nodes[node].parent >= 0) {
+        int weight = nodes[node].weight;
+
+        // highest number holding this weight: weights are sorted by number above node
+        int low = nodes[node].number, high = capacity - 1;
+        while (low < high) {
+            int mid = (low + high + 1) / 2;
+            if (nodes[nodeAt[mid]].weight == weight) low = mid;
+            else high = mid - 1;
+        }
+        // an ancestor can only share the weight if the parent does
+        if (nodes[nodes[node].parent].weight == weight) {
+            while (low > nodes[node].number && isAncestor(nodeAt[low], node)) --low;
+        }
+        if (nodeAt[low] != node) swapNodes(node, nodeAt[low]);
+
+        ++nodes[node].weight;
+        node = nodes[node].parent;
+    }
+    ++nodes[node].weight;
+}
+
+#endif // ADAPTIVE_HUFFMAN_H
@@ -0,0 +1,92 @@
+#ifndef BYTE_CODEC_H
+#define BYTE_CODEC_H
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+/*
+ * ByteCodec: the small integer / number encodings shared by the compressors'
+ * byte formats (binary product records, block container, column archive).
+ *  + appendUint / readUint: fixed-width big-endian unsigned integer
+ *  + appendVarint / readVarint: LEB128 (7 bits per byte, low group first);
+ *      readVarint advances in and returns false on a truncated varint
+ *  + appendValue / readValue: a double as one varint zigzag(m) << 3 | k when
+ *      value == m / 10^k for some k in 0..6 (the smallest is used); k == 7
+ *      marks the 8 IEEE-754 bytes following instead. Exact either way.
+ */
+struct ByteCodec {
+    static void appendUint(std::string& out, unsigned long long value, int bytes) {
+        for (int shift = 8 * (bytes - 1); shift >= 0; shift -= 8) {
+            out.push_back((char)((value >> shift) & 0xff));
+        }
+    }
+
+    static unsigned long long readUint(const unsigned char* in, int bytes) {
+        unsigned long long value = 0;
+        for (int i = 0; i < bytes; ++i) value = (value << 8) | in[i];
+        return value;
+    }
+
+    static void appendVarint(std::string& out, unsigned long long value) {
+        do {
+            unsigned char byte = value & 0x7f;
+            value >>= 7;
+            out.push_back((char)(value ? (byte | 0x80) : byte));
+        } while (value);
+    }
+
+    static bool readVarint(const unsigned char*& in, const unsigned char* end, unsigned long long& value) {
+        value = 0;
+        for (int shift = 0; in < end && shift < 64; shift += 7) {
+            unsigned char byte = *in++;
+            value |= (unsigned long long)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    static void appendValue(std::string& out, double value) {
+        for (int k = 0; k < 7; ++k) {
+            double scaled = value * scale(k);
+            if (!(std::fabs(scaled) < 0x1p59)) break;
+            long long m = (long long)scaled;
+            if ((double)m == scaled && (double)m / scale(k) == value && !(m == 0 && std::signbit(value))) {
+                unsigned long long zigzag = ((unsigned long long)m << 1) ^ (unsigned long long)(m >> 63);
+                appendVarint(out, (zigzag << 3) | (unsigned long long)k);
+                return;
+            }
+        }
+
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendVarint(out, 7);
+        appendUint(out, bits, 8);
+    }
+
+    static bool readValue(const unsigned char*& in, const unsigned char* end, double& value) {
+        unsigned long long packed;
+        if (!readVarint(in, end, packed)) return false;
+
+        int k = (int)(packed & 7);
+        if (k == 7) {
+            if (end - in < 8) return false;
+            unsigned long long bits = readUint(in, 8);
+            in += 8;
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        }
+        unsigned long long zigzag = packed >> 3;
+        long long m = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+        value = (double)m / scale(k);
+        return true;
+    }
+
+private:
+    static double scale(int k) {
+        static const double scales[7] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+        return scales[k];
+    }
+};
+
+#endif // BYTE_CODEC_H
@@ -0,0 +1,97 @@
+#ifndef CHAR_HISTOGRAM_H
+#define CHAR_HISTOGRAM_H
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include "list/XArrayList.h"
+
+/*
+ * CharHistogram<lanes>: byte-frequency counter for building Huffman codes.
+ *
+ * One flat 256-entry table per lane; consecutive bytes of a block go to
+ * different lanes so that runs of the same character (",  ", "000") do not
+ * serialise on a single counter's load/increment/store. The lanes are only
+ * summed when the histogram is read.
+ */
+template <int lanes = 4>
+class CharHistogram {
+public:
+    static_assert(lanes >= 1, "CharHistogram needs at least one lane");
+
+    CharHistogram() { clear(); }
+
+    void clear() { std::memset(counts, 0, sizeof(counts)); }
+
+    void add(char c) { ++counts[0][(unsigned char)c]; }
+
+    void add(const char* data, size_t length) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + lanes <= length; i += lanes) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                ++counts[lane][bytes[i + lane]];
+            }
+        }
+        for (; i < length; ++i) {
+            ++counts[0][bytes[i]];
+        }
+    }
+
+    void add(const std::string& text) { add(text.data(), text.size()); }
+
+    // Take back bytes added earlier (a product that left the inventory). Lane 0
+    // may wrap below zero, but count() sums the lanes modulo 2^64, so totals
+    // stay exact as long as only added bytes are removed.
+    void remove(const char* data, size_t length) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            --counts[0][bytes[i]];
+        }
+    }
+
+    void remove(const std::string& text) { remove(text.data(), text.size()); }
+
+    // Fold another histogram (e.g. one counted over a different slice) into this one.
+    template <int otherLanes>
+    void merge(const CharHistogram<otherLanes>& other) {
+        for (int c = 0; c < 256; ++c) {
+            counts[0][c] += other.count((char)c);
+        }
+    }
+
+    unsigned long long count(char c) const {
+        unsigned long long total = 0;
+        for (int lane = 0; lane < lanes; ++lane) {
+            total += counts[lane][(unsigned char)c];
+        }
+        return total;
+    }
+
+    int symbols() const {
+        int used = 0;
+        for (int c = 0; c < 256; ++c) {
+            if (count((char)c) != 0) ++used;
+        }
+        return used;
+    }
+
+    /*
+     * toFreqList(freqList): append (symbol, count) for every byte seen, in
+     * ascending (signed) char order -- the order buildHuffman has always
+     * handed symbols to the tree, so ties break exactly as before.
+     */
+    void toFreqList(XArrayList<std::pair<char, int>>& freqList) const {
+        for (int c = -128; c < 128; ++c) {
+            unsigned long long total = count((char)c);
+            if (total != 0) {
+                freqList.add({(char)c, (int)total});
+            }
+        }
+    }
+
+private:
+    unsigned long long counts[lanes][256];
+};
+
+#endif // CHAR_HISTOGRAM_H
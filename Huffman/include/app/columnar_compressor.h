@@ -0,0 +1,428 @@
+#ifndef COLUMNAR_COMPRESSOR_H
+#define COLUMNAR_COMPRESSOR_H
+
+#include <vector>
+
+#include "inventory_compressor.h"
+
+/*
+ * ColumnarCompressor<treeOrder>: compresses a whole inventory column by
+ * column instead of product by product. The rows are transposed into
+ *  + a name column: [length: varint][name bytes] per product
+ *  + a quantity column: zigzag varint per product
+ *  + a layout column: [attribute count: varint][name id: varint]... per
+ *      product, ids indexing the archive's attribute dictionary
+ *  + one value column per attribute name: that attribute's values in product
+ *      order, each in ByteCodec::appendValue form
+ * and every column gets its own canonical Huffman code over its bytes, so the
+ * digits of "power" values are not modelled together with product names.
+ *
+ * Archive layout (varints are LEB128):
+ *   "HUFC" [treeOrder] [products: varint]
+ *   dictionary: [count: varint] then [length: varint][name bytes] per name
+ *   directory:  [columns: varint] then per column
+ *               [kind: 1 byte] [attribute id: varint, value columns only] [bytes: varint]
+ *   the column blocks, back to back in directory order, each
+ *     [raw bytes: varint] [symbols: varint] [(symbol, code length) pairs]
+ *     [code bits: varint] [packed digits, bitsPerDigit each, MSB first]
+ *   a column of one distinct byte has the pair (byte, 0) and no code bits: it
+ *   is that byte [raw bytes] times
+ * The directory's byte counts let a reader step over columns it does not need
+ * (see the projection overload of decompress).
+ * decompress throws std::runtime_error on a malformed archive.
+ */
+template<int treeOrder>
+class ColumnarCompressor {
+public:
+    ColumnarCompressor(InventoryManager* manager);
+
+    std::string compress();
+    InventoryManager decompress(const std::string& archive);
+
+    /*
+     * decompress(archive, attributes, names, quantities): projection read.
+     * Only the layout column, the value columns of the listed attribute names
+     * and (when asked for) the name / quantity columns are Huffman decoded;
+     * every other column is skipped by its directory byte count. Rows keep
+     * only the listed attributes, in their stored order; names come back as
+     * "" and quantities as 0 when not requested. Names that no product has
+     * simply match nothing.
+     */
+    InventoryManager decompress(const std::string& archive, const List1D<std::string>& attributes,
+                                bool names = false, bool quantities = false);
+
+private:
+    enum ColumnKind { NAME_COLUMN = 0, QUANTITY_COLUMN = 1, LAYOUT_COLUMN = 2, VALUE_COLUMN = 3 };
+
+    static void encodeColumn(const std::string& raw, std::string& out);
+    static bool decodeColumn(const unsigned char* in, const unsigned char* end, std::string& raw,
+                             unsigned long long runLimit);
+    static bool peekLength(const unsigned char* in, const unsigned char* end, unsigned long long& rawLength);
+    static void invalidArchive();
+    InventoryManager decodeArchive(const std::string& archive, const List1D<std::string>* attributes,
+                                   bool withNames, bool withQuantities);
+
+    static int charHashFunc(char &key, int tableSize) {
+        return static_cast<unsigned char>(key) % tableSize;
+    }
+    static int stringHashFunc(std::string &key, int tableSize) {
+        unsigned int hash = 2166136261u;
+        for (char c : key) hash = (hash ^ (unsigned char)c) * 16777619u;
+        return (int)(hash % (unsigned int)tableSize);
+    }
+    InventoryManager* invManager;
+};
+
+
+template <int treeOrder>
+ColumnarCompressor<treeOrder>::ColumnarCompressor(InventoryManager *manager)
+{
+    invManager = manager;
+}
+
+template <int treeOrder>
+void ColumnarCompressor<treeOrder>::invalidArchive()
+{
+    throw std::runtime_error("Invalid columnar archive");
+}
+
+template <int treeOrder>
+void ColumnarCompressor<treeOrder>::encodeColumn(const std::string &raw, std::string &out)
+{
+    ByteCodec::appendVarint(out, raw.length());
+    if (raw.empty()) return;
+
+    CharHistogram<4> histogram;
+    histogram.add(raw);
+    XArrayList<pair<char, int>> freqList;
+    histogram.toFreqList(freqList);
+    if (freqList.size() == 1) {
+        ByteCodec::appendVarint(out, 1);
+        out.push_back(freqList.get(0).first);
+        out.push_back(0);
+        ByteCodec::appendVarint(out, 0);
+        return;
+    }
+
+    // keep every code within 56 bits so that it packs with one shift
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    HuffmanTree<treeOrder> tree;
+    tree.buildLengthLimited(freqList, 56 / digitBits);
+    XArrayList<pair<char, int>> lengths;
+    tree.codeLengths(lengths);
+    tree.buildFromCodeLengths(lengths);
+
+    ByteCodec::appendVarint(out, (unsigned long long)lengths.size());
+    for (int i = 0; i < lengths.size(); ++i) {
+        out.push_back(lengths.get(i).first);
+        out.push_back((char)lengths.get(i).second);
+    }
+
+    xMap<char, std::string> table(&charHashFunc);
+    tree.generateCodes(table);
+    unsigned long long codeBits[256];
+    int codeLength[256];
+    for (int i = 0; i < lengths.size(); ++i) {
+        char symbol = lengths.get(i).first;
+        const std::string& code = table.get(symbol);
+        unsigned long long bits = 0;
+        for (char c : code) {
+            int digit = (c <= '9') ? (c - '0') : (c - 'a' + 10);
+            bits = (bits << digitBits) | (unsigned long long)digit;
+        }
+        codeBits[(unsigned char)symbol] = bits;
+        codeLength[(unsigned char)symbol] = (int)code.length() * digitBits;
+    }
+
+    std::string packed;
+    packed.reserve(raw.length());
+    unsigned long long word = 0, totalBits = 0;
+    int wordBits = 0;
+    for (unsigned char c : raw) {
+        word = (word << codeLength[c]) | codeBits[c];
+        wordBits += codeLength[c];
+        totalBits += codeLength[c];
+        while (wordBits >= 8) {
+            wordBits -= 8;
+            packed.push_back((char)(word >> wordBits));
+        }
+    }
+    if (wordBits > 0) packed.push_back((char)(word << (8 - wordBits)));
+
+    ByteCodec::appendVarint(out, totalBits);
+    out += packed;
+}
+
+/*
+ * decodeColumn: rawLength is checked before anything is allocated. A coded
+ * column spends at least one digit per byte, so it can hold no more than
+ * totalBits / bitsPerDigit bytes; a one-byte column has no bits to bound it,
+ * so the caller passes runLimit, the most such a column can hold.
+ */
+template <int treeOrder>
+bool ColumnarCompressor<treeOrder>::decodeColumn(const unsigned char *in, const unsigned char *end, std::string &raw,
+                                                 unsigned long long runLimit)
+{
+    raw.clear();
+    unsigned long long rawLength;
+    if (!ByteCodec::readVarint(in, end, rawLength)) return false;
+    if (rawLength == 0) return in == end;
+
+    unsigned long long symbols, totalBits;
+    if (!ByteCodec::readVarint(in, end, symbols) || symbols == 0 || symbols > 256 ||
+        (unsigned long long)(end - in) < 2 * symbols) {
+        return false;
+    }
+    XArrayList<pair<char, int>> lengths;
+    for (unsigned long long i = 0; i < symbols; ++i, in += 2) {
+        lengths.add({(char)in[0], in[1]});
+    }
+    if (!ByteCodec::readVarint(in, end, totalBits) || totalBits / 8 + (totalBits % 8 != 0) != (unsigned long long)(end - in)) {
+        return false;
+    }
+
+    if (symbols == 1) {
+        if (lengths.get(0).second != 0 || totalBits != 0 || rawLength > runLimit) return false;
+        raw.assign((size_t)rawLength, lengths.get(0).first);
+        return true;
+    }
+    if (rawLength > totalBits / HuffmanTree<treeOrder>::bitsPerDigit) return false;
+
+    HuffmanTree<treeOrder> tree;
+    try {
+        tree.buildFromCodeLengths(lengths);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    raw.reserve((size_t)rawLength);
+    if (!tree.decodePacked(in, 0, (long long)totalBits, raw)) return false;
+    return raw.length() == rawLength;
+}
+
+template <int treeOrder>
+bool ColumnarCompressor<treeOrder>::peekLength(const unsigned char *in, const unsigned char *end, unsigned long long &rawLength)
+{
+    return in != nullptr && ByteCodec::readVarint(in, end, rawLength);
+}
+
+template <int treeOrder>
+std::string ColumnarCompressor<treeOrder>::compress()
+{
+    int products = invManager->size();
+
+    // attribute dictionary, in order of first appearance
+    xMap<std::string, int> attributeIds(&stringHashFunc);
+    XArrayList<std::string> attributeNames;
+    for (int i = 0; i < products; ++i) {
+        int count = invManager->getAttributeCount(i);
+        for (int a = 0; a < count; ++a) {
+            const std::string& name = invManager->getAttribute(i, a).name;
+            bool added;
+            attributeIds.findOrPut(name, attributeNames.size(), &added);
+            if (added) attributeNames.add(name);
+        }
+    }
+
+    // transpose the rows into raw columns
+    std::string names, quantities, layout;
+    std::vector<std::string> values(attributeNames.size());
+    for (int i = 0; i < products; ++i) {
+        const std::string& name = invManager->getProductNameRef(i);
+        ByteCodec::appendVarint(names, name.length());
+        names += name;
+
+        long long quantity = invManager->getProductQuantity(i);
+        ByteCodec::appendVarint(quantities, ((unsigned long long)quantity << 1) ^ (unsigned long long)(quantity >> 63));
+
+        int count = invManager->getAttributeCount(i);
+        ByteCodec::appendVarint(layout, (unsigned long long)count);
+        for (int a = 0; a < count; ++a) {
+            const InventoryAttribute& attr = invManager->getAttribute(i, a);
+            int id = attributeIds.get(attr.name);
+            ByteCodec::appendVarint(layout, (unsigned long long)id);
+            ByteCodec::appendValue(values[id], attr.value);
+        }
+    }
+
+    std::string archive = "HUFC";
+    archive.push_back((char)treeOrder);
+    ByteCodec::appendVarint(archive, (unsigned long long)products);
+    ByteCodec::appendVarint(archive, (unsigned long long)attributeNames.size());
+    for (int i = 0; i < attributeNames.size(); ++i) {
+        ByteCodec::appendVarint(archive, attributeNames.get(i).length());
+        archive += attributeNames.get(i);
+    }
+
+    int columns = 3 + attributeNames.size();
+    std::vector<std::string> blocks(columns);
+    encodeColumn(names, blocks[0]);
+    encodeColumn(quantities, blocks[1]);
+    encodeColumn(layout, blocks[2]);
+    for (int a = 0; a < attributeNames.size(); ++a) {
+        encodeColumn(values[a], blocks[3 + a]);
+    }
+
+    ByteCodec::appendVarint(archive, (unsigned long long)columns);
+    for (int c = 0; c < columns; ++c) {
+        if (c < 3) {
+            archive.push_back((char)(c == 0 ? NAME_COLUMN : c == 1 ? QUANTITY_COLUMN : LAYOUT_COLUMN));
+        } else {
+            archive.push_back((char)VALUE_COLUMN);
+            ByteCodec::appendVarint(archive, (unsigned long long)(c - 3));
+        }
+        ByteCodec::appendVarint(archive, blocks[c].length());
+    }
+    for (int c = 0; c < columns; ++c) archive += blocks[c];
+    return archive;
+}
+
+template <int treeOrder>
+InventoryManager ColumnarCompressor<treeOrder>::decompress(const std::string &archive)
+{
+    return decodeArchive(archive, nullptr, true, true);
+}
+
+template <int treeOrder>
+InventoryManager ColumnarCompressor<treeOrder>::decompress(const std::string &archive, const List1D<std::string> &attributes,
+                                                           bool names, bool quantities)
+{
+    return decodeArchive(archive, &attributes, names, quantities);
+}
+
+template <int treeOrder>
+InventoryManager ColumnarCompressor<treeOrder>::decodeArchive(const std::string &archive, const List1D<std::string> *attributes,
+                                                              bool withNames, bool withQuantities)
+{
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(archive.data());
+    const unsigned char* end = in + archive.length();
+    if (archive.length() < 5 || archive.compare(0, 4, "HUFC") != 0 || in[4] != treeOrder) {
+        invalidArchive();
+    }
+    in += 5;
+
+    unsigned long long products, attributeCount, columns;
+    if (!ByteCodec::readVarint(in, end, products) ||
+        !ByteCodec::readVarint(in, end, attributeCount) || attributeCount > (unsigned long long)(end - in)) {
+        invalidArchive();
+    }
+    List1D<std::string> attributeNames;
+    for (unsigned long long i = 0; i < attributeCount; ++i) {
+        unsigned long long length;
+        if (!ByteCodec::readVarint(in, end, length) || length > (unsigned long long)(end - in)) invalidArchive();
+        attributeNames.add(std::string(reinterpret_cast<const char*>(in), length));
+        in += length;
+    }
+
+    // slots 0..2: name, quantity, layout; slot 3 + id: values of attribute id
+    int slots = 3 + (int)attributeCount;
+    std::vector<bool> wanted(slots);
+    wanted[NAME_COLUMN] = withNames;
+    wanted[QUANTITY_COLUMN] = withQuantities;
+    wanted[LAYOUT_COLUMN] = false;
+    for (int id = 0; id < (int)attributeCount; ++id) {
+        wanted[3 + id] = attributes == nullptr;
+        for (int r = 0; attributes != nullptr && r < attributes->size() && !wanted[3 + id]; ++r) {
+            wanted[3 + id] = attributes->at(r) == attributeNames.at(id);
+        }
+        // the layout is only needed to place the values of some attribute
+        wanted[LAYOUT_COLUMN] = wanted[LAYOUT_COLUMN] || wanted[3 + id];
+    }
+
+    // directory: where each column's block starts and ends
+    std::vector<const unsigned char*> blockStart(slots, nullptr), blockEnd(slots, nullptr);
+    bool valid = ByteCodec::readVarint(in, end, columns) && columns <= (unsigned long long)(end - in);
+    std::vector<unsigned long long> sizes(valid ? columns : 0);
+    std::vector<int> slotOf(valid ? columns : 0);
+    for (unsigned long long c = 0; c < columns && valid; ++c) {
+        unsigned long long id = 0;
+        int kind = (in < end) ? *in++ : -1;
+        if (kind == VALUE_COLUMN) {
+            valid = ByteCodec::readVarint(in, end, id) && id < attributeCount;
+        } else {
+            valid = kind >= NAME_COLUMN && kind <= LAYOUT_COLUMN;
+        }
+        valid = valid && ByteCodec::readVarint(in, end, sizes[c]) && sizes[c] <= (unsigned long long)(end - in);
+        slotOf[c] = (kind == VALUE_COLUMN) ? 3 + (int)id : kind;
+    }
+    for (unsigned long long c = 0; c < columns && valid; ++c) {
+        int slot = slotOf[c];
+        valid = blockStart[slot] == nullptr && sizes[c] <= (unsigned long long)(end - in);
+        blockStart[slot] = in;
+        blockEnd[slot] = in + (valid ? sizes[c] : 0);
+        in = blockEnd[slot];
+    }
+    valid = valid && in == end;
+
+    // every product takes at least one byte of the quantity and the layout
+    // column, so their raw lengths bound products even when neither is decoded
+    unsigned long long quantityBytes, layoutBytes;
+    valid = valid && products <= 0x7fffffff &&
+            peekLength(blockStart[QUANTITY_COLUMN], blockEnd[QUANTITY_COLUMN], quantityBytes) && products <= quantityBytes &&
+            peekLength(blockStart[LAYOUT_COLUMN], blockEnd[LAYOUT_COLUMN], layoutBytes) && products <= layoutBytes;
+
+    // decode only the wanted columns; the others are stepped over. In a column
+    // of one distinct byte every varint is that single byte: a name or layout
+    // row is at most 128 bytes, a quantity 1, a value 9 per layout entry
+    std::vector<std::string> raw(slots);
+    for (int s = 0; s < slots && valid; ++s) {
+        if (!wanted[s]) continue;
+        if (blockStart[s] == nullptr) {
+            valid = s > LAYOUT_COLUMN; // a value column may be absent only if no product uses it
+            continue;
+        }
+        unsigned long long runLimit = (s == QUANTITY_COLUMN) ? products
+                                    : (s > LAYOUT_COLUMN) ? 9 * (unsigned long long)raw[LAYOUT_COLUMN].length()
+                                    : 128 * products;
+        valid = decodeColumn(blockStart[s], blockEnd[s], raw[s], runLimit);
+    }
+
+    List2D<InventoryAttribute> matrix;
+    List1D<std::string> names;
+    List1D<int> quantities;
+    std::vector<const unsigned char*> cursor(slots), cursorEnd(slots);
+    for (int s = 0; s < slots; ++s) {
+        cursor[s] = reinterpret_cast<const unsigned char*>(raw[s].data());
+        cursorEnd[s] = cursor[s] + raw[s].length();
+    }
+    for (unsigned long long i = 0; i < products && valid; ++i) {
+        if (withNames) {
+            unsigned long long nameLength;
+            const unsigned char*& name = cursor[NAME_COLUMN];
+            valid = ByteCodec::readVarint(name, cursorEnd[NAME_COLUMN], nameLength) &&
+                    nameLength <= (unsigned long long)(cursorEnd[NAME_COLUMN] - name);
+            if (!valid) break;
+            names.add(std::string(reinterpret_cast<const char*>(name), nameLength));
+            name += nameLength;
+        } else {
+            names.add("");
+        }
+
+        unsigned long long quantity = 0, count = 0;
+        if (withQuantities) {
+            valid = ByteCodec::readVarint(cursor[QUANTITY_COLUMN], cursorEnd[QUANTITY_COLUMN], quantity);
+        }
+        quantities.add((int)(long long)((quantity >> 1) ^ -(quantity & 1)));
+        if (wanted[LAYOUT_COLUMN]) {
+            valid = valid && ByteCodec::readVarint(cursor[LAYOUT_COLUMN], cursorEnd[LAYOUT_COLUMN], count);
+        }
+
+        List1D<InventoryAttribute> row;
+        for (unsigned long long a = 0; a < count && valid; ++a) {
+            unsigned long long id;
+            double value;
+            valid = ByteCodec::readVarint(cursor[LAYOUT_COLUMN], cursorEnd[LAYOUT_COLUMN], id) && id < attributeCount;
+            if (!valid || !wanted[3 + id]) continue;
+            valid = ByteCodec::readValue(cursor[3 + id], cursorEnd[3 + id], value);
+            if (valid) row.add(InventoryAttribute(attributeNames.at((int)id), value));
+        }
+        matrix.setRow((int)i, row);
+    }
+    for (int s = 0; s < slots && valid; ++s) {
+        valid = cursor[s] == cursorEnd[s];
+    }
+
+    if (!valid) invalidArchive();
+    return InventoryManager(matrix, names, quantities);
+}
+
+#endif // COLUMNAR_COMPRESSOR_H
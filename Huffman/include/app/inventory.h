@@ -27,6 +27,7 @@ public:
     List1D<T> &operator=(const List1D<T> &other); 
     int size() const;
     T get(int index) const;
+    const T &at(int index) const; // like get, without the copy
     void set(int index, T value);
     void add(const T &value);
 
@@ -55,6 +56,9 @@ public:
     void removeAt(int index);
     void setRow(int rowIndex, const List1D<T> &row);
     T get(int rowIndex, int colIndex) const;
+    //! read-only views that avoid copying the row / element
+    int columns(int rowIndex) const;
+    const T &at(int rowIndex, int colIndex) const;
     List1D<T> getRow(int rowIndex) const;
     string toString() const;
     template <typename U> //! thêm vào  để chạy test 
@@ -104,6 +108,10 @@ public:
     List1D<InventoryAttribute> getProductAttributes(int index) const;
     string getProductName(int index) const;
     int getProductQuantity(int index) const;
+    //! copy-free accessors for hot loops (compressor frequency counting)
+    int getAttributeCount(int index) const;
+    const InventoryAttribute &getAttribute(int index, int attrIndex) const;
+    const string &getProductNameRef(int index) const;
     void updateQuantity(int index, int newQuantity);
     void addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
     void removeProduct(int index);
@@ -213,6 +221,16 @@ T List1D<T>::get(int index) const
     return this->pList->get(index); 
 }
 
+template <typename T>
+const T &List1D<T>::at(int index) const
+{
+    if (index < 0 || index >= this->pList->size()) {
+            throw out_of_range("Index is out of range!");
+    }
+
+    return this->pList->get(index);
+}
+
 template <typename T>
 void List1D<T>::set(int index, T value)
 {
@@ -358,12 +376,16 @@ void List2D<T>::setRow(int rowIndex, const List1D<T> &row)
         throw out_of_range("Index is out of range!");
     }
 
-    while (rowIndex >= this->rows()) this->pMatrix->add(new XArrayList<T>());
-    
     // Create a new row with copied data
-    XArrayList<T>* newRow = new XArrayList<T>();
+    XArrayList<T>* newRow = new XArrayList<T>(nullptr, nullptr, row.size() > 0 ? row.size() : 1);
     for (int i = 0; i < row.size(); i++) {
-        newRow->add(row.get(i));
+        newRow->add(row.at(i));
+    }
+
+    // Appending: no old row to replace
+    if (rowIndex == this->rows()) {
+        this->pMatrix->add(newRow);
+        return;
     }
     
     // Delete old row
@@ -383,6 +405,18 @@ T List2D<T>::get(int rowIndex, int colIndex) const
     return pMatrix->get(rowIndex)->get(colIndex);
 }
 
+template <typename T>
+int List2D<T>::columns(int rowIndex) const
+{
+    return pMatrix->get(rowIndex)->size();
+}
+
+template <typename T>
+const T &List2D<T>::at(int rowIndex, int colIndex) const
+{
+    return pMatrix->get(rowIndex)->get(colIndex);
+}
+
 template <typename T>
 List1D<T> List2D<T>::getRow(int rowIndex) const
 {
@@ -1,13 +1,23 @@
 #ifndef INVENTORY_COMPRESSOR_H
 #define INVENTORY_COMPRESSOR_H
 
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <stdexcept>
 #include <utility>
 #include "inventory.h"
+#include "adaptive_huffman.h"
+#include "char_histogram.h"
+#include "byte_codec.h"
+#include "util/parallelFor.h"
+#include "util/digitTranslate.h"
 #include "hash/xMap.h"
 #include "heap/Heap.h"
 #include "list/XArrayList.h"
@@ -16,11 +26,19 @@
 template<int treeOrder>
 class HuffmanTree {
 public:
+    /*
+     * HuffmanNode: one slot of the tree's node arena. Children are not owned
+     * pointers but the index range [firstChild, firstChild + childCount) of
+     * the same arena, so siblings are always adjacent in memory.
+     */
     struct HuffmanNode {
         char ch;
         int freq;
         int order;      // Added to track leaf order
-        XArrayList<HuffmanNode*> children;
+        int state;      // decode-table row of an internal node, -1 otherwise
+        int firstChild; // arena index of child 0
+        int childCount; // 0 for a leaf
+        bool pad;       // zero-weight filler leaf; never decodes to a symbol
 
         static int huffmanCompare(HuffmanNode*& nodeA, HuffmanNode*& nodeB) {
             if (nodeA->freq != nodeB->freq)
@@ -32,26 +50,159 @@ public:
             return 0;
         }
         
+        HuffmanNode()
+            : ch('\0'), freq(0), order(1), state(-1), firstChild(-1), childCount(0), pad(true) {}
+
         HuffmanNode(char ch, int freq)
-            : ch(ch), freq(freq), order(1), children() {}
+            : ch(ch), freq(freq), order(1), state(-1), firstChild(-1), childCount(0), pad(false) {}
 
-        HuffmanNode(int freq, const XArrayList<HuffmanNode*>& childrens)
-            : ch('\0'), freq(freq), order(1), children(childrens) {}
+        bool isLeaf() const { return childCount == 0; }
 
         ~HuffmanNode(){}
 
     };
 
+    // Bits needed to store one N-ary digit in a packed stream: ceil(log2(treeOrder))
+    static constexpr int bitsPerDigit = (treeOrder <= 2) ? 1 : (treeOrder <= 4) ? 2 : (treeOrder <= 8) ? 3 : 4;
+
+    // Digits consumed per decode-table lookup: the largest K with treeOrder^K <= 256
+    static constexpr int decodeChunk = (treeOrder <= 2) ? 8 : (treeOrder <= 3) ? 5 : (treeOrder <= 4) ? 4
+                                     : (treeOrder <= 6) ? 3 : 2;
+
+    // Power-of-two orders get the specialised decode kernels: a chunk of
+    // digits is assembled with shifts, and packed input is cut from the
+    // stream in one extraction with no per-digit range check.
+    static constexpr bool powerOfTwo = (treeOrder & (treeOrder - 1)) == 0;
+
     HuffmanTree();
     ~HuffmanTree();
     
-    void generateCodes(xMap<char, std::string>& table);
+    void generateCodes(IMap<char, std::string>& table);
     std::string decode(const std::string& huffmanCode);
+    std::string decodeTreeWalk(const std::string& huffmanCode);
+
+    // decode / decodePacked through the generic (any treeOrder) kernels
+    std::string decodeGeneric(const std::string& huffmanCode) { return decodeKernel<false>(huffmanCode); }
+    bool decodePackedGeneric(const unsigned char* data, long long firstBit, long long bitCount, std::string& out) {
+        return decodePackedKernel<false>(data, firstBit, bitCount, out);
+    }
+
+    /*
+     * decodePacked(data, firstBit, bitCount, out): table decode straight from
+     * bit-packed digits (bitsPerDigit bits each, MSB first) in
+     * [firstBit, firstBit + bitCount), appending the symbols to out. Returns
+     * false where decode() would return "\\x00".
+     */
+    bool decodePacked(const unsigned char* data, long long firstBit, long long bitCount, std::string& out);
+
+    // decode/decodePacked build their lookup table lazily on first use; call
+    // prepareDecode first when several threads are about to decode at once.
+    void prepareDecode() { if (!decodeTableReady) buildDecodeTable(); }
     void build(XArrayList<pair<char, int>>& symbolsFreqs);
 
+    /*
+     * buildTwoQueue: same tree as build(), without the heap. Leaves (and pads)
+     * are sorted once by (freq, order); since merged weights never decrease,
+     * internal nodes come out already sorted, so the next treeOrder smallest
+     * nodes are always at the fronts of the leaf queue and the internal queue.
+     * Linear after the sort. Frequencies must be non-negative.
+     */
+    void buildTwoQueue(XArrayList<pair<char, int>>& symbolsFreqs);
+
+    /*
+     * buildLengthLimited: optimal prefix code whose codes are at most
+     * maxCodeLength digits, by package-merge generalised to treeOrder-ary
+     * packages; the tree is laid out canonically. Throws std::runtime_error
+     * when treeOrder^maxCodeLength cannot hold all symbols.
+     */
+    void buildLengthLimited(XArrayList<pair<char, int>>& symbolsFreqs, int maxCodeLength);
+
+    /*
+     * Canonical codes: a codebook is fully described by (symbol, code length)
+     * pairs. Symbols are ordered by (length, unsigned symbol); the first gets
+     * all zeros, each next one is the previous code plus one, then padded
+     * with trailing zeros up to its own length.
+     *  + codeLengths: (symbol, length) of every real leaf, in canonical order
+     *  + generateCanonicalCodes: canonical codes for the current lengths
+     *  + buildFromCodeLengths: reshape the tree so that its codes are canonical;
+     *      throws std::runtime_error if the lengths cannot form a prefix code
+     *      or name a symbol twice
+     */
+    void codeLengths(XArrayList<pair<char, int>>& lengths);
+    void generateCanonicalCodes(IMap<char, std::string>& table);
+    void buildFromCodeLengths(XArrayList<pair<char, int>>& lengths);
+
 private:
-    HuffmanNode* root;
-    void traverse(HuffmanNode *node, std::string code, xMap<char, std::string> &table);
+    /*
+     * DecodeEntry: outcome of feeding decodeChunk digits to the tree from one
+     * internal node (a "state"). Every leaf reached on the way is emitted and
+     * the walk restarts at root; next == -1 marks an invalid path (pad leaf or
+     * missing child).
+     */
+    struct DecodeEntry {
+        int next;
+        int count;
+        char symbols[decodeChunk];
+    };
+
+    HuffmanNode* nodes;                 // node arena, root first, siblings contiguous
+    int nodeCount;
+    HuffmanNode* root;                  // &nodes[0], or nullptr for an empty tree
+    XArrayList<HuffmanNode*> states;    // internal nodes, indexed by HuffmanNode::state
+    DecodeEntry* decodeTable;           // states.size() rows of chunkSpan() entries, built lazily
+    bool decodeTableReady;
+
+    static constexpr int chunkSpan() {
+        int span = 1;
+        for (int i = 0; i < decodeChunk; ++i) span *= treeOrder;
+        return span;
+    }
+    static int digitValue(char c) {
+        static const signed char values[256] = {
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,  0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
+        return values[(unsigned char)c];
+    }
+    template <bool specialised>
+    std::string decodeKernel(const std::string& huffmanCode);
+    template <bool specialised>
+    bool decodePackedKernel(const unsigned char* data, long long firstBit, long long bitCount, std::string& out);
+    void buildDecodeTable();
+    void releaseDecodeTable();
+    void destroyNodes();
+    void adoptArena(HuffmanNode* scratch, int total, const int* childSlots);
+    static void sortByFreq(HuffmanNode* scratch, int* ids, int n);
+    HuffmanNode* childOf(HuffmanNode* node, int i) { return nodes + node->firstChild + i; }
+    void collectLengths(HuffmanNode *node, int depth, XArrayList<pair<char, int>> &lengths);
+    static void sortCanonical(XArrayList<pair<char, int>> &lengths);
+    static bool nextCanonicalCode(std::string &code, int length);
+    void traverse(HuffmanNode *node, std::string code, IMap<char, std::string> &table);
+};
+
+/*
+ * SerializationMode: the byte form of a product that the compressor's
+ * Huffman codes are built over (see InventoryCompressor::setSerializationMode).
+ */
+enum SerializationMode { TEXT_SERIALIZATION, BINARY_SERIALIZATION };
+
+/*
+ * HuffmanBatch: a whole inventory encoded by InventoryCompressor::encodeAll.
+ * Every product's code is bit-packed back to back into data (bitsPerDigit
+ * bits per digit, MSB first, no padding between products); product i
+ * occupies bits [bitOffsets.get(i), bitOffsets.get(i + 1)).
+ */
+struct HuffmanBatch {
+    std::string data;
+    List1D<long long> bitOffsets;
+
+    int size() const { return bitOffsets.size() > 0 ? bitOffsets.size() - 1 : 0; }
+    long long bits() const { return bitOffsets.size() > 0 ? bitOffsets.get(bitOffsets.size() - 1) : 0; }
 };
 
 template<int treeOrder>
@@ -60,150 +211,913 @@ public:
     InventoryCompressor(InventoryManager* manager);
     ~InventoryCompressor();
 
-    void buildHuffman();
+    void buildHuffman(bool canonical = false);
     void printHuffmanTable();
+
+    // Cap code lengths at maxLength digits on the next buildHuffman (canonical
+    // codes, via HuffmanTree::buildLengthLimited); 0 removes the cap.
+    void setMaxCodeLength(int maxLength);
+
+    /*
+     * countFrequencies(histogram, first, last): add the characters of the
+     * serialised products [first, last) (last < 0: up to the end) to histogram.
+     * Products are streamed into one reused buffer, so no string is built per
+     * product; buildHuffman uses it over the whole inventory.
+     */
+    template <int lanes>
+    void countFrequencies(CharHistogram<lanes>& histogram, int first = 0, int last = -1);
+
+    /*
+     * setThreadCount(threads): worker threads for buildHuffman and encodeAll
+     * (0 or less: one per hardware thread; default 1). With more than one, the
+     * inventory is cut into row ranges: buildHuffman counts one histogram per
+     * range in parallel and merges them into a single tree, and encodeAll
+     * encodes the ranges in parallel as separate blocks, then stitches them
+     * into the same HuffmanBatch a serial encodeAll would produce.
+     */
+    void setThreadCount(int threads);
+
+    /*
+     * setSerializationMode(mode): what gets Huffman coded; set it before
+     * buildHuffman, and use the same mode to decode.
+     *  + TEXT_SERIALIZATION (default): productToString's text
+     *  + BINARY_SERIALIZATION: one compact record per product,
+     *      [name length: varint][name][attribute count: varint] and, per
+     *      attribute, [name id: varint][value: varint]. The value varint is
+     *      zigzag(m) << 3 | k for value == m / 10^k, with the smallest exact
+     *      k in 0..6; k == 7 means the 8 IEEE-754 bytes follow instead.
+     *      Values round-trip exactly. Name ids index a dictionary of attribute
+     *      names that buildHuffman collects; attributeDictionary /
+     *      loadAttributeDictionary carry it next to codebookHeader. Decoding
+     *      returns the product's productToString text.
+     * serializeProduct gives the bytes a product is coded as in the current mode.
+     */
+    void setSerializationMode(SerializationMode mode);
+    std::string serializeProduct(const List1D<InventoryAttribute>& attributes, const std::string& name);
+    std::string attributeDictionary();
+    void loadAttributeDictionary(const std::string& dictionary);
+
+    /*
+     * Codebook header: [treeOrder][count: 2 bytes, big endian] followed by one
+     * (symbol, code length) byte pair per symbol. It describes canonical codes,
+     * so it only round-trips a table built with buildHuffman(true).
+     * loadCodebook rebuilds both encoder and decoder from such a header and
+     * throws std::runtime_error on a malformed one, keeping the current
+     * codebook as it was.
+     */
+    std::string codebookHeader();
+    void loadCodebook(const std::string& header);
     std::string productToString(const List1D<InventoryAttribute>& attributes, const std::string& name);
+
+    /*
+     * parseProduct(text, attributesOutput, nameOutput): productToString's
+     * inverse, and the text half of decodeHuffman. Returns text when it parses,
+     * "" for a malformed attribute and "\\x00" for a malformed product. Works
+     * on string_views of text with std::from_chars: no substrings, no streams.
+     */
+    std::string parseProduct(const std::string& text, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
     std::string encodeHuffman(const List1D<InventoryAttribute>& attributes, const std::string& name);
     std::string decodeHuffman(const std::string& huffmanCode, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
 
+    // Bit-packed variants: each digit takes HuffmanTree<treeOrder>::bitsPerDigit bits, MSB first.
+    // encodeHuffman returns the number of bits written into buffer.
+    int encodeHuffman(const List1D<InventoryAttribute>& attributes, const std::string& name, unsigned char* buffer, int bufferSize);
+    std::string decodeHuffman(const unsigned char* buffer, int bitCount, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
+
+    /*
+     * Batch API over the whole inventory, with no per-product strings:
+     *  + encodeAll: encode every product of the manager into batch (its old
+     *      content is replaced); throws like encodeHuffman on a missing symbol
+     *  + decodeAll: decode every product of batch in one pass, appending one
+     *      row / name per product (an empty row and "" for a product that
+     *      fails to decode). Returns the number of products decoded cleanly.
+     */
+    void encodeAll(HuffmanBatch& batch);
+    int decodeAll(const HuffmanBatch& batch, List2D<InventoryAttribute>& attributesOutput, List1D<std::string>& namesOutput);
+
+    /*
+     * Block container: a self-describing byte string holding a whole encoded
+     * inventory, cut into blocks of syncInterval products that can be decoded
+     * independently (all integers big endian):
+     *   "HUFB" [treeOrder] [products: 4] [syncInterval: 4] [lengths bytes: 4]
+     *   sync table, one entry per block:
+     *     [first product index: 4] [digit offset: 8] [offset into lengths: 4]
+     *   lengths: every product's code length in digits, as LEB128 varints
+     *   data: the packed digits, as in HuffmanBatch
+     * The codebook is not included (see codebookHeader).
+     *  + encodeContainer: encodeAll, then pack the result
+     *  + decodeContainer: decode every block, on up to setThreadCount threads,
+     *      and append the rows / names in product order (an empty row and ""
+     *      for a product that fails to decode). Returns the number of products
+     *      decoded cleanly; throws std::runtime_error on a malformed container.
+     */
+    std::string encodeContainer(int syncInterval = 1024);
+    int decodeContainer(const std::string& container, List2D<InventoryAttribute>& attributesOutput, List1D<std::string>& namesOutput);
+
+    /*
+     * Live codebook. buildHuffman keeps the character histogram it counted;
+     * inventory changes made through the methods below update it by deltas
+     * (only the product concerned is serialised) instead of a new pass over
+     * the inventory:
+     *  + addProduct / removeProduct / updateQuantity: forward to the manager
+     *      (quantities are not coded, so updateQuantity leaves the code alone)
+     *  + the code is rebuilt from the histogram alone when a product brings a
+     *      character it has no code for, or when estimatedInefficiency exceeds
+     *      setRebuildThreshold (default 0.05)
+     *  + estimatedInefficiency: how far the current code has drifted, as
+     *      (cost / entropy) / (cost / entropy at the last rebuild) - 1, where
+     *      cost is the histogram's total code length in digits
+     *  + codebookVersion: bumped by every build or rebuild; products encoded
+     *      under an older version need that version's codebook
+     *  + frequencyHistogram: the histogram itself
+     * In binary mode new attribute names are appended to the dictionary.
+     * Changes made to the manager directly are not seen until buildHuffman.
+     */
+    void addProduct(const List1D<InventoryAttribute>& attributes, const std::string& name, int quantity);
+    void removeProduct(int index);
+    void updateQuantity(int index, int newQuantity);
+    void setRebuildThreshold(double threshold);
+    double estimatedInefficiency();
+    int codebookVersion() const { return version; }
+    const CharHistogram<4>& frequencyHistogram() const { return liveHistogram; }
+
+    /*
+     * Adaptive mode, for products coded as they arrive (e.g. a live addProduct
+     * feed): no buildHuffman pass and no codebook. encodeAdaptive codes a
+     * product's productToString text with an AdaptiveHuffmanTree that learns
+     * from every product it has coded; decodeAdaptive runs the mirror model,
+     * so a reader must decode the writer's products in the order they were
+     * encoded. decodeAdaptive returns like decodeHuffman; after a "\\x00" the
+     * models are out of step and both sides must resetAdaptive.
+     * Independent of buildHuffman and of setSerializationMode.
+     */
+    std::string encodeAdaptive(const List1D<InventoryAttribute>& attributes, const std::string& name);
+    std::string decodeAdaptive(const std::string& huffmanCode, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
+    void resetAdaptive();
+
 private:
+    long long encodeRange(int first, int last, std::string& data, long long* productEnds);
+    void encodeAllParallel(HuffmanBatch& batch);
+    /*
+     * ParseOutcome: what parseText found, in decodeHuffman's terms:
+     * PARSE_OK -> the text itself, PARSE_EMPTY -> "", PARSE_INVALID -> "\\x00".
+     */
+    enum ParseOutcome { PARSE_OK, PARSE_EMPTY, PARSE_INVALID };
+    ParseOutcome parseText(std::string_view decoded, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
+    static bool parseNumber(std::string_view text, double& value);
+    static void appendAttribute(const InventoryAttribute& attr, std::string& out);
+    static void appendValue(double value, std::string& out);
+    void appendProduct(int index, std::string& out);
+    bool parseRecord(const std::string& decoded, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
+
+    template <class AttributeAt>
+    void appendBinaryProduct(const std::string& name, int attributeCount, AttributeAt attributeAt, std::string& out);
+    bool parseBinaryProduct(const std::string& record, List1D<InventoryAttribute>& attributesOutput, std::string& nameOutput);
+    void collectAttributeNames();
+    int attributeId(const std::string& name);
+
+    /*
+     * CodeEntry: flat encoder table slot, indexed by unsigned char. bits holds
+     * the code's digits packed bitsPerDigit each, first digit most significant
+     * (only when length * bitsPerDigit <= 64); the digit text itself sits at
+     * codeText[textOffset .. +length). length < 0: the symbol has no code.
+     */
+    struct CodeEntry {
+        unsigned long long bits;
+        int length;
+        int textOffset;
+    };
+    void rebuildCodeTable();
+    void buildFromHistogram();
+    void histogramChanged(const std::string& serialized);
+    void codeCost(double& cost, double& entropy);
+    void symbolNotFound(char c);
+    template <class ByteSink>
+    void packCode(const CodeEntry& entry, unsigned long long& word, int& wordBits, ByteSink emit);
+
     static int charHashFunc(char &key, int tableSize) {
-        return static_cast<int>(key) % tableSize;
+        return static_cast<unsigned char>(key) % tableSize;
+    }
+    static int stringHashFunc(std::string &key, int tableSize) {
+        unsigned int hash = 2166136261u;
+        for (char c : key) hash = (hash ^ (unsigned char)c) * 16777619u;
+        return (int)(hash % (unsigned int)tableSize);
     }
     xMap<char, std::string>* huffmanTable;
     InventoryManager* invManager;
     HuffmanTree<treeOrder>* tree;
+    int maxCodeLength;
+    int threadCount;
+    SerializationMode serializationMode;
+    xMap<std::string, int>* attributeIds;
+    XArrayList<std::string> attributeNames;
+    CodeEntry codeTable[256];
+    std::string codeText;
+    AdaptiveHuffmanTree<treeOrder>* adaptiveEncoder;
+    AdaptiveHuffmanTree<treeOrder>* adaptiveDecoder;
+    CharHistogram<4> liveHistogram;   // characters of the inventory, kept by buildHuffman
+    bool histogramLive;
+    bool canonicalCodes;
+    double rebuildThreshold;
+    double builtRatio;                // cost / entropy right after the last (re)build
+    int version;
 };
 
 
-#endif // INVENTORY_COMPRESSOR_H
-
 template <int treeOrder>
 HuffmanTree<treeOrder>::HuffmanTree() {
+    nodes = nullptr;
+    nodeCount = 0;
     root = nullptr;
+    decodeTable = nullptr;
+    decodeTableReady = false;
 }
 
 template <int treeOrder>
 HuffmanTree<treeOrder>::~HuffmanTree() {
-    if (root != nullptr) {
-        XArrayList<HuffmanNode*> toDelete;
-        toDelete.add(root);
+    releaseDecodeTable();
+    destroyNodes();
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::destroyNodes() {
+    delete[] nodes;
+    nodes = nullptr;
+    nodeCount = 0;
+    root = nullptr;
+}
 
-        while (!toDelete.empty()) {
-            HuffmanNode* node = toDelete.removeAt(0);
+/*
+ * adoptArena(scratch, total, childSlots):
+ *  lay the merge-order scratch tree out breadth-first into the final arena so
+ *  that every node's children occupy consecutive slots. In scratch, an
+ *  internal node lists its children as childSlots[firstChild .. +childCount);
+ *  the root is the last scratch node.
+ */
+template <int treeOrder>
+void HuffmanTree<treeOrder>::adoptArena(HuffmanNode* scratch, int total, const int* childSlots) {
+    nodes = new HuffmanNode[total];
+    nodeCount = total;
 
-            for (int i = 0; i < node->children.size(); ++i) {
-                toDelete.add(node->children.get(i));
+    int* queue = new int[total];
+    int head = 0, tail = 0;
+    queue[tail++] = total - 1;
+    while (head < tail) {
+        int placed = head;
+        HuffmanNode& node = nodes[placed];
+        node = scratch[queue[head++]];
+        if (!node.isLeaf()) {
+            int first = tail;
+            for (int i = 0; i < node.childCount; ++i) {
+                queue[tail++] = childSlots[node.firstChild + i];
             }
-
-            delete node;
+            node.firstChild = first;
         }
     }
+    delete[] queue;
+    root = nodes;
 }
 
 template <int treeOrder>
 void HuffmanTree<treeOrder>::build(XArrayList<pair<char, int>>& symbolsFreqs) {
-    if (root) {
-        XArrayList<HuffmanNode*> queue;
-        queue.add(root);
+    releaseDecodeTable();
+    destroyNodes();
+
+    if (symbolsFreqs.size() == 0) return;
+
+    int leafCount = symbolsFreqs.size();
+    int padNeeded = (leafCount - 1) % (treeOrder - 1);
+    if (padNeeded != 0) padNeeded = (treeOrder - 1) - padNeeded;
+    int internalCount = (leafCount + padNeeded - 1) / (treeOrder - 1);
+    int total = leafCount + padNeeded + internalCount;
 
-        while (!queue.empty()) {
-            HuffmanNode* current = queue.removeAt(queue.size() - 1);
+    // one scratch block for every node the merge will create
+    HuffmanNode* scratch = new HuffmanNode[total];
+    HuffmanNode** ready = new HuffmanNode*[leafCount + padNeeded];
+    int* childSlots = new int[internalCount * treeOrder];
+    int count = 0;
+
+    for (int i = 0; i < leafCount; ++i) {
+        scratch[count] = HuffmanNode(symbolsFreqs.get(i).first, symbolsFreqs.get(i).second);
+        scratch[count].order = count;
+        ready[count] = &scratch[count];
+        count++;
+    }
+    for (int i = 0; i < padNeeded; i++) {
+        scratch[count] = HuffmanNode();
+        scratch[count].order = count;
+        ready[count] = &scratch[count];
+        count++;
+    }
+
+    Heap<HuffmanNode *> heap(HuffmanNode::huffmanCompare);
+    heap.heapify(ready, count);
+    delete[] ready;
+
+    int slot = 0;
+    while (heap.size() >= treeOrder) {
+        HuffmanNode& internalNode = scratch[count];
+        internalNode = HuffmanNode('\0', 0);
+        internalNode.firstChild = slot;
+        
+        for (int nodeIndex = 0; nodeIndex < treeOrder; nodeIndex++) {
+            HuffmanNode* extractedNode = heap.pop();
             
-            for (int j = 0; j < current->children.size(); ++j) {
-                queue.add(current->children.get(j));
-            }
+            internalNode.freq += extractedNode->freq;     
+            childSlots[slot++] = (int)(extractedNode - scratch);
+        }
+        
+        internalNode.childCount = treeOrder;
+        internalNode.order = count++;
+        heap.push(&internalNode);
+    }
+
+    adoptArena(scratch, total, childSlots);
+    delete[] childSlots;
+    delete[] scratch;
+}
 
-            delete current;
+/*
+ * sortByFreq(scratch, ids, n):
+ *  stable bottom-up merge sort of node ids by freq; ids come in by
+ *  increasing order, so stability yields (freq, order) ordering
+ */
+template <int treeOrder>
+void HuffmanTree<treeOrder>::sortByFreq(HuffmanNode* scratch, int* ids, int n) {
+    int* buffer = new int[n];
+    int* from = ids;
+    int* to = buffer;
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = (lo + width < n) ? lo + width : n;
+            int hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+            int a = lo, b = mid, out = lo;
+            while (a < mid && b < hi) {
+                to[out++] = (scratch[from[b]].freq < scratch[from[a]].freq) ? from[b++] : from[a++];
+            }
+            while (a < mid) to[out++] = from[a++];
+            while (b < hi) to[out++] = from[b++];
         }
-        root = nullptr;
+        int* swapTmp = from;
+        from = to;
+        to = swapTmp;
+    }
+    if (from != ids) {
+        for (int i = 0; i < n; ++i) ids[i] = from[i];
     }
+    delete[] buffer;
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::buildTwoQueue(XArrayList<pair<char, int>>& symbolsFreqs) {
+    releaseDecodeTable();
+    destroyNodes();
 
     if (symbolsFreqs.size() == 0) return;
 
-    Heap<HuffmanNode *> heap(HuffmanNode::huffmanCompare);
+    int leafCount = symbolsFreqs.size();
+    int padNeeded = (leafCount - 1) % (treeOrder - 1);
+    if (padNeeded != 0) padNeeded = (treeOrder - 1) - padNeeded;
+    int internalCount = (leafCount + padNeeded - 1) / (treeOrder - 1);
+    int total = leafCount + padNeeded + internalCount;
+
+    HuffmanNode* scratch = new HuffmanNode[total];
+    int* leafQueue = new int[leafCount + padNeeded];
+    int* childSlots = new int[internalCount * treeOrder];
     int count = 0;
 
-    for (int i = 0; i < symbolsFreqs.size(); ++i) {
-        HuffmanNode *leaf = new HuffmanNode(symbolsFreqs.get(i).first, symbolsFreqs.get(i).second);
-        leaf->order = count++;
-        heap.push(leaf);
+    for (int i = 0; i < leafCount; ++i) {
+        scratch[count] = HuffmanNode(symbolsFreqs.get(i).first, symbolsFreqs.get(i).second);
+        scratch[count].order = count;
+        leafQueue[count] = count;
+        count++;
+    }
+    for (int i = 0; i < padNeeded; i++) {
+        scratch[count] = HuffmanNode();
+        scratch[count].order = count;
+        leafQueue[count] = count;
+        count++;
     }
+    sortByFreq(scratch, leafQueue, count);
+
+    // internal nodes are created in order, so scratch itself is the second queue
+    const int leafEnd = count;
+    const int internalBase = count;
+    int leafHead = 0;
+    int internalHead = internalBase;
+
+    int slot = 0;
+    for (int merged = 0; merged < internalCount; ++merged) {
+        HuffmanNode& internalNode = scratch[count];
+        internalNode = HuffmanNode('\0', 0);
+        internalNode.firstChild = slot;
 
-    int padNeeded = (heap.size() - 1) % (treeOrder - 1);
-    if (padNeeded != 0) {
-        padNeeded = (treeOrder - 1) - padNeeded;
-        for (int i = 0; i < padNeeded; i++) {
-            HuffmanNode *padNode = new HuffmanNode('\0', 0);
-            padNode->order = count++;
-            heap.push(padNode);
+        for (int nodeIndex = 0; nodeIndex < treeOrder; nodeIndex++) {
+            int pick;
+            if (internalHead == count) {
+                pick = leafQueue[leafHead++];
+            } else if (leafHead == leafEnd) {
+                pick = internalHead++;
+            } else {
+                // leaves always carry a smaller order than internal nodes
+                pick = (scratch[internalHead].freq < scratch[leafQueue[leafHead]].freq)
+                     ? internalHead++ : leafQueue[leafHead++];
+            }
+            internalNode.freq += scratch[pick].freq;
+            childSlots[slot++] = pick;
         }
+
+        internalNode.childCount = treeOrder;
+        internalNode.order = count++;
     }
 
-    while (heap.size() >= treeOrder) {
-        int combinedFrequency = 0;
-        XArrayList<HuffmanNode*> childCollection;
-        
-        for (int nodeIndex = 0; nodeIndex < treeOrder; nodeIndex++) {
-            if (heap.empty()) break;
+    adoptArena(scratch, total, childSlots);
+    delete[] childSlots;
+    delete[] leafQueue;
+    delete[] scratch;
+}
 
-            HuffmanNode* extractedNode = heap.pop();
-            
-            combinedFrequency += extractedNode->freq;     
-            childCollection.add(extractedNode);
+/*
+ * Package-merge, treeOrder-ary:
+ *  + pad the symbols with zero-weight leaves to m, (m - 1) % (treeOrder - 1) == 0,
+ *    like build() does; a full tree over them has (m - 1) / (treeOrder - 1)
+ *    internal nodes
+ *  + every leaf offers one coin per depth 1..maxCodeLength; at the deepest level
+ *    the list is just the sorted leaves, and each shallower list merges the
+ *    sorted leaves with packages of treeOrder consecutive items of the list below
+ *  + the cheapest treeOrder * internal items of the depth-1 list are selected;
+ *    a selected package selects its treeOrder parts one level down, and a
+ *    leaf's code length is the number of its selected coins
+ */
+template <int treeOrder>
+void HuffmanTree<treeOrder>::buildLengthLimited(XArrayList<pair<char, int>>& symbolsFreqs, int maxCodeLength) {
+    releaseDecodeTable();
+    destroyNodes();
+
+    int leafCount = symbolsFreqs.size();
+    if (leafCount == 0) return;
+    if (leafCount == 1) {
+        build(symbolsFreqs);
+        return;
+    }
+
+    int padNeeded = (leafCount - 1) % (treeOrder - 1);
+    if (padNeeded != 0) padNeeded = (treeOrder - 1) - padNeeded;
+    int m = leafCount + padNeeded;
+    int internalCount = (m - 1) / (treeOrder - 1);
+
+    long long capacity = 1;
+    for (int l = 0; l < maxCodeLength && capacity < m; ++l) capacity *= treeOrder;
+    if (maxCodeLength < 1 || capacity < m) {
+        throw std::runtime_error("Code length limit is too small");
+    }
+
+    // leaves sorted by (weight, order); pads are weight 0
+    HuffmanNode* scratch = new HuffmanNode[m];
+    int* sortedLeaves = new int[m];
+    for (int i = 0; i < m; ++i) {
+        scratch[i] = (i < leafCount) ? HuffmanNode(symbolsFreqs.get(i).first, symbolsFreqs.get(i).second)
+                                     : HuffmanNode();
+        scratch[i].order = i;
+        sortedLeaves[i] = i;
+    }
+    sortByFreq(scratch, sortedLeaves, m);
+
+    // levels[l]: list for depth l + 1; item >= 0 is a leaf id, -1 a package
+    const int levels = maxCodeLength;
+    int** item = new int*[levels];
+    long long** weight = new long long*[levels];
+    int* size = new int[levels];
+
+    item[levels - 1] = new int[m];
+    weight[levels - 1] = new long long[m];
+    size[levels - 1] = m;
+    for (int i = 0; i < m; ++i) {
+        item[levels - 1][i] = sortedLeaves[i];
+        weight[levels - 1][i] = scratch[sortedLeaves[i]].freq;
+    }
+
+    for (int l = levels - 2; l >= 0; --l) {
+        int packages = size[l + 1] / treeOrder;
+        size[l] = m + packages;
+        item[l] = new int[size[l]];
+        weight[l] = new long long[size[l]];
+
+        int leaf = 0, pack = 0, out = 0;
+        while (leaf < m || pack < packages) {
+            long long packWeight = 0;
+            if (pack < packages) {
+                for (int k = 0; k < treeOrder; ++k) packWeight += weight[l + 1][pack * treeOrder + k];
+            }
+            // ties go to the leaf, keeping the selection deterministic
+            if (pack >= packages || (leaf < m && scratch[sortedLeaves[leaf]].freq <= packWeight)) {
+                item[l][out] = sortedLeaves[leaf];
+                weight[l][out++] = scratch[sortedLeaves[leaf++]].freq;
+            } else {
+                item[l][out] = -1;
+                weight[l][out++] = packWeight;
+                pack++;
+            }
         }
-        
-        HuffmanNode* internalNode = new HuffmanNode(combinedFrequency, childCollection);
-        internalNode->order = count++;
-        heap.push(internalNode);
     }
 
-    if (heap.size() > 1) {
-        XArrayList<HuffmanNode*> mergeNodes;
-        int totalWeight = 0;
-        
-        while (heap.size() > 0) {
-            HuffmanNode* nextNode = heap.pop();
-            totalWeight += nextNode->freq;
-            mergeNodes.add(nextNode);
+    XArrayList<pair<char, int>> lengths;
+    int* codeLength = new int[m];
+    for (int i = 0; i < m; ++i) codeLength[i] = 0;
+
+    int selected = treeOrder * internalCount;
+    for (int l = 0; l < levels && selected > 0; ++l) {
+        int packagesSelected = 0;
+        for (int i = 0; i < selected; ++i) {
+            if (item[l][i] >= 0) codeLength[item[l][i]]++;
+            else packagesSelected++;
         }
-        
-        HuffmanNode* rootNode = new HuffmanNode(totalWeight, mergeNodes);
-        rootNode->order = count++;
-        root = rootNode;
+        selected = packagesSelected * treeOrder;
+    }
+    for (int i = 0; i < leafCount; ++i) {
+        lengths.add({scratch[i].ch, codeLength[i]});
+    }
 
-    } else if (heap.size() == 1) {
-        root = heap.pop();
-    } else {
-        root = nullptr;
+    for (int l = 0; l < levels; ++l) {
+        delete[] item[l];
+        delete[] weight[l];
     }
+    delete[] item;
+    delete[] weight;
+    delete[] size;
+    delete[] codeLength;
+    delete[] sortedLeaves;
+    delete[] scratch;
+
+    buildFromCodeLengths(lengths);
 }
 
 template <int treeOrder>
-void HuffmanTree<treeOrder>::generateCodes(xMap<char, std::string> &table) {
+void HuffmanTree<treeOrder>::generateCodes(IMap<char, std::string> &table) {
     if (root == nullptr) return;
     traverse(root, "", table);
 }
 
 template <int treeOrder>
-void HuffmanTree<treeOrder>::traverse(HuffmanNode *node, std::string code, xMap<char, std::string> &table) {
+void HuffmanTree<treeOrder>::traverse(HuffmanNode *node, std::string code, IMap<char, std::string> &table) {
     if (!node) return;
 
-    if (node->children.empty()) {
-        if (node->ch != '\0') {
+    if (node->isLeaf()) {
+        if (!node->pad) {
             table.put(node->ch, code);
             return;
         }
     }
     
-    for (int i = 0; i < node->children.size(); ++i) {
+    for (int i = 0; i < node->childCount; ++i) {
         char next = (i < 10) ? ('0' + i) : ('a' + (i - 10));
-        traverse(node->children.get(i), code + next, table);
+        traverse(childOf(node, i), code + next, table);
+    }
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::collectLengths(HuffmanNode *node, int depth, XArrayList<pair<char, int>> &lengths) {
+    if (node->isLeaf()) {
+        if (!node->pad) lengths.add({node->ch, depth});
+        return;
+    }
+    for (int i = 0; i < node->childCount; ++i) {
+        collectLengths(childOf(node, i), depth + 1, lengths);
+    }
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::sortCanonical(XArrayList<pair<char, int>> &lengths) {
+    for (int i = 1; i < lengths.size(); i++) {
+        pair<char, int> current = lengths.get(i);
+        int j = i - 1;
+
+        while (j >= 0 && (lengths.get(j).second > current.second ||
+               (lengths.get(j).second == current.second &&
+                (unsigned char)lengths.get(j).first > (unsigned char)current.first))) {
+            lengths.get(j + 1) = lengths.get(j);
+            j--;
+        }
+        lengths.get(j + 1) = current;
+    }
+}
+
+/*
+ * nextCanonicalCode(code, length):
+ *  advance code (digits '0'..) to the next canonical code of the given length.
+ *  An empty code means "no code assigned yet". Returns false when the code
+ *  space is exhausted (lengths violate the Kraft inequality).
+ */
+template <int treeOrder>
+bool HuffmanTree<treeOrder>::nextCanonicalCode(std::string &code, int length) {
+    if (code.empty()) {
+        code.assign(length, '0');
+        return true;
+    }
+
+    int pos = (int)code.length() - 1;
+    while (pos >= 0) {
+        int digit = digitValue(code[pos]) + 1;
+        if (digit < treeOrder) {
+            code[pos] = (digit < 10) ? ('0' + digit) : ('a' + (digit - 10));
+            break;
+        }
+        code[pos] = '0';
+        pos--;
+    }
+    if (pos < 0) return false;
+
+    code.append(length - code.length(), '0');
+    return true;
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::codeLengths(XArrayList<pair<char, int>> &lengths) {
+    lengths.clear();
+    if (root == nullptr) return;
+    collectLengths(root, 0, lengths);
+    sortCanonical(lengths);
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::generateCanonicalCodes(IMap<char, std::string> &table) {
+    XArrayList<pair<char, int>> lengths;
+    codeLengths(lengths);
+
+    std::string code;
+    for (int i = 0; i < lengths.size(); ++i) {
+        if (!nextCanonicalCode(code, lengths.get(i).second)) return;
+        table.put(lengths.get(i).first, code);
+    }
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::buildFromCodeLengths(XArrayList<pair<char, int>> &lengths) {
+    releaseDecodeTable();
+    destroyNodes();
+    if (lengths.size() == 0) return;
+
+    XArrayList<pair<char, int>> sorted(lengths);
+    sortCanonical(sorted);
+
+    // a lone symbol of length 0 is a root leaf, as build() produces for one symbol
+    if (sorted.size() == 1 && sorted.get(0).second == 0) {
+        nodes = new HuffmanNode[1];
+        nodes[0] = HuffmanNode(sorted.get(0).first, 0);
+        nodeCount = 1;
+        root = nodes;
+        return;
+    }
+
+    // the arena grows in blocks of treeOrder pad leaves: turning a pad into
+    // an internal node appends its whole child block at once
+    int capacity = 1 + treeOrder * 8;
+    nodes = new HuffmanNode[capacity];
+    nodes[0].firstChild = 1;
+    nodes[0].childCount = treeOrder;
+    nodeCount = 1 + treeOrder;
+    root = nodes;
+
+    std::string code;
+    bool seen[256] = {false};
+    for (int i = 0; i < sorted.size(); ++i) {
+        int length = sorted.get(i).second;
+        unsigned char symbol = (unsigned char)sorted.get(i).first;
+        if (length < 1 || seen[symbol] || !nextCanonicalCode(code, length)) {
+            destroyNodes();
+            throw std::runtime_error("Invalid code lengths");
+        }
+
+        int node = 0;
+        for (int d = 0; d + 1 < length; ++d) {
+            int child = nodes[node].firstChild + digitValue(code[d]);
+            if (nodes[child].isLeaf()) {
+                // canonical order only ever descends into pads, never real leaves
+                if (nodeCount + treeOrder > capacity) {
+                    capacity *= 2;
+                    HuffmanNode* grown = new HuffmanNode[capacity];
+                    for (int k = 0; k < nodeCount; ++k) grown[k] = nodes[k];
+                    delete[] nodes;
+                    nodes = grown;
+                    root = nodes;
+                }
+                nodes[child].firstChild = nodeCount;
+                nodes[child].childCount = treeOrder;
+                nodeCount += treeOrder;
+            }
+            node = child;
+        }
+        HuffmanNode& leaf = nodes[nodes[node].firstChild + digitValue(code[length - 1])];
+        leaf.ch = sorted.get(i).first;
+        leaf.pad = false;
+        seen[symbol] = true;
+    }
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::releaseDecodeTable() {
+    delete[] decodeTable;
+    decodeTable = nullptr;
+    decodeTableReady = false;
+    states.clear();
+}
+
+template <int treeOrder>
+void HuffmanTree<treeOrder>::buildDecodeTable() {
+    releaseDecodeTable();
+    decodeTableReady = true;
+    if (root == nullptr || root->isLeaf()) return;
+
+    // number the internal nodes in arena order; row 0 is always root
+    for (int i = 0; i < nodeCount; ++i) {
+        if (!nodes[i].isLeaf()) {
+            nodes[i].state = states.size();
+            states.add(&nodes[i]);
+        }
+    }
+
+    const int span = chunkSpan();
+    decodeTable = new DecodeEntry[states.size() * span];
+
+    int digits[decodeChunk];
+    for (int s = 0; s < states.size(); ++s) {
+        for (int chunk = 0; chunk < span; ++chunk) {
+            int rest = chunk;
+            for (int d = decodeChunk - 1; d >= 0; --d) {
+                digits[d] = rest % treeOrder;
+                rest /= treeOrder;
+            }
+
+            DecodeEntry& entry = decodeTable[s * span + chunk];
+            entry.count = 0;
+            HuffmanNode* node = states.get(s);
+            for (int d = 0; d < decodeChunk && node != nullptr; ++d) {
+                if (digits[d] >= node->childCount) {
+                    node = nullptr;
+                    break;
+                }
+                node = childOf(node, digits[d]);
+                if (node->isLeaf()) {
+                    if (node->pad) {
+                        node = nullptr;
+                        break;
+                    }
+                    entry.symbols[entry.count++] = node->ch;
+                    node = root;
+                }
+            }
+            entry.next = (node == nullptr) ? -1 : node->state;
+        }
     }
 }
 
 template <int treeOrder>
 std::string HuffmanTree<treeOrder>::decode(const std::string &huffmanCode)
+{
+    return decodeKernel<powerOfTwo>(huffmanCode);
+}
+
+template <int treeOrder>
+template <bool specialised>
+std::string HuffmanTree<treeOrder>::decodeKernel(const std::string &huffmanCode)
+{
+    if (root == nullptr || huffmanCode.empty()) return "\\x00";
+    if (root->isLeaf()) return "\\x00";
+    if (!decodeTableReady) buildDecodeTable();
+
+    const int span = chunkSpan();
+    const size_t length = huffmanCode.length();
+    const char* digits = huffmanCode.data();
+
+    // every symbol costs at least one digit, so length bounds the output
+    std::string result(length + decodeChunk, '\0');
+    char* out = &result[0];
+    int state = 0;
+
+    // digits are validated and turned into values a block at a time
+    // (translateDigits), so the walk below reads indices with no checks
+    // and the block stays in L1; a block is a whole number of chunks
+    constexpr size_t block = decodeChunk * 1024;
+    unsigned char values[block];
+    size_t blockStart = 0, count = 0, i = 0;
+    for (; blockStart < length; blockStart += count) {
+        count = (length - blockStart < block) ? length - blockStart : block;
+        if (!translateDigits(digits + blockStart, count, treeOrder, values)) return "\\x00";
+
+        const size_t tableEnd = count - count % decodeChunk;
+        for (i = 0; i < tableEnd; i += decodeChunk) {
+            int chunk = 0;
+            for (int d = 0; d < decodeChunk; ++d) {
+                if constexpr (specialised) chunk = (chunk << bitsPerDigit) | values[i + d];
+                else chunk = chunk * treeOrder + values[i + d];
+            }
+
+            const DecodeEntry& entry = decodeTable[state * span + chunk];
+            if (entry.next < 0) return "\\x00";
+            memcpy(out, entry.symbols, decodeChunk);
+            out += entry.count;
+            state = entry.next;
+        }
+    }
+    result.resize(out - result.data());
+
+    // fewer than decodeChunk digits left (end of the last block): finish with a plain walk
+    HuffmanNode *node = states.get(state);
+    for (; i < count; ++i) {
+        int idx = values[i];
+        if (idx >= node->childCount) return "\\x00";
+
+        node = childOf(node, idx);
+        if (node->isLeaf()) {
+            if (node->pad) return "\\x00";
+            result.push_back(node->ch);
+            node = root;
+        }
+    }
+    return result;
+}
+
+template <int treeOrder>
+bool HuffmanTree<treeOrder>::decodePacked(const unsigned char *data, long long firstBit, long long bitCount, std::string &out)
+{
+    return decodePackedKernel<powerOfTwo>(data, firstBit, bitCount, out);
+}
+
+template <int treeOrder>
+template <bool specialised>
+bool HuffmanTree<treeOrder>::decodePackedKernel(const unsigned char *data, long long firstBit, long long bitCount, std::string &out)
+{
+    if (root == nullptr || bitCount <= 0 || bitCount % bitsPerDigit != 0) return false;
+    if (root->isLeaf()) return false;
+    if (!decodeTableReady) buildDecodeTable();
+
+    const int span = chunkSpan();
+    const int mask = (1 << bitsPerDigit) - 1;
+    const long long length = bitCount / bitsPerDigit;
+    const long long tableEnd = length - length % decodeChunk;
+
+    // a digit never straddles more than two bytes (bitsPerDigit <= 4)
+    long long bitPos = firstBit;
+    auto nextDigit = [&]() {
+        long long byteIdx = bitPos >> 3;
+        int window = data[byteIdx] << 8;
+        if (((bitPos & 7) + bitsPerDigit) > 8) window |= data[byteIdx + 1];
+        int digit = (window >> (16 - (bitPos & 7) - bitsPerDigit)) & mask;
+        bitPos += bitsPerDigit;
+        return digit;
+    };
+
+    size_t start = out.size();
+    out.resize(start + length + decodeChunk);
+    char* write = &out[start];
+    int state = 0;
+
+    long long i = 0;
+    for (; i < tableEnd; i += decodeChunk) {
+        int chunk = 0;
+        if constexpr (specialised) {
+            // the chunk's digits are its bits: cut all of them (8 bits, or 6
+            // for order 8) out of a 16-bit window at once; every value is valid
+            constexpr int chunkBits = bitsPerDigit * decodeChunk;
+            long long byteIdx = bitPos >> 3;
+            int offset = (int)(bitPos & 7);
+            int window = data[byteIdx] << 8;
+            if (offset + chunkBits > 8) window |= data[byteIdx + 1];
+            chunk = (window >> (16 - offset - chunkBits)) & ((1 << chunkBits) - 1);
+            bitPos += chunkBits;
+        } else {
+            for (int d = 0; d < decodeChunk; ++d) {
+                int idx = nextDigit();
+                if (idx >= treeOrder) { out.resize(start); return false; }
+                chunk = chunk * treeOrder + idx;
+            }
+        }
+
+        const DecodeEntry& entry = decodeTable[state * span + chunk];
+        if (entry.next < 0) { out.resize(start); return false; }
+        memcpy(write, entry.symbols, decodeChunk);
+        write += entry.count;
+        state = entry.next;
+    }
+    out.resize(write - out.data());
+
+    HuffmanNode *node = states.get(state);
+    for (; i < length; ++i) {
+        int idx = nextDigit();
+        if (idx >= treeOrder || idx >= node->childCount) { out.resize(start); return false; }
+
+        node = childOf(node, idx);
+        if (node->isLeaf()) {
+            if (node->pad) { out.resize(start); return false; }
+            out.push_back(node->ch);
+            node = root;
+        }
+    }
+    return true;
+}
+
+template <int treeOrder>
+std::string HuffmanTree<treeOrder>::decodeTreeWalk(const std::string &huffmanCode)
 {
     if (root == nullptr || huffmanCode.empty()) return "\\x00";
 
@@ -218,12 +1132,12 @@ std::string HuffmanTree<treeOrder>::decode(const std::string &huffmanCode)
         int idx = (c >= '0' && c <= '9') ? (c - '0') :
                   (c >= 'a' && c <= 'f') ? (c - 'a' + 10) : -1;
 
-        if (idx < 0 || idx >= treeOrder || idx >= node->children.size()) return "\\x00";
+        if (idx < 0 || idx >= treeOrder || idx >= node->childCount) return "\\x00";
         
-        node = node->children.get(idx);
+        node = childOf(node, idx);
         
-        if (node->children.empty()) {
-            if (node->ch == '\0') return "\\x00";
+        if (node->isLeaf()) {
+            if (node->pad) return "\\x00";
             result.push_back(node->ch);
             node = root;
         }
@@ -236,6 +1150,18 @@ InventoryCompressor<treeOrder>::InventoryCompressor(InventoryManager* manager) {
     this->huffmanTable = new xMap<char, string>(&charHashFunc);
     this->tree = new HuffmanTree<treeOrder>();
     this->invManager = manager;
+    this->maxCodeLength = 0;
+    this->threadCount = 1;
+    this->serializationMode = TEXT_SERIALIZATION;
+    this->attributeIds = new xMap<std::string, int>(&stringHashFunc);
+    this->adaptiveEncoder = new AdaptiveHuffmanTree<treeOrder>();
+    this->adaptiveDecoder = new AdaptiveHuffmanTree<treeOrder>();
+    this->histogramLive = false;
+    this->canonicalCodes = false;
+    this->rebuildThreshold = 0.05;
+    this->builtRatio = 0;
+    this->version = 0;
+    rebuildCodeTable();
 }
 
 template <int treeOrder>
@@ -243,44 +1169,42 @@ InventoryCompressor<treeOrder>::~InventoryCompressor()
 {
     delete tree;
     delete huffmanTable;
+    delete attributeIds;
+    delete adaptiveEncoder;
+    delete adaptiveDecoder;
 }
 
 template <int treeOrder>
-void InventoryCompressor<treeOrder>::buildHuffman()
+void InventoryCompressor<treeOrder>::buildHuffman(bool canonical)
 {
-    xMap<char, int> freqMap(&charHashFunc);
-
-    for (int i = 0; i < invManager->size(); ++i) {
-        std::string str = productToString(invManager->getProductAttributes(i), invManager->getProductName(i));
-        
-        for (char chars : str) {
-            int count = freqMap.containsKey(chars) ? freqMap.get(chars) + 1 : 1;
-            freqMap.put(chars, count);
-        }
+    if (serializationMode == BINARY_SERIALIZATION) {
+        collectAttributeNames();
     }
 
-    DLinkedList<char> keys = freqMap.keys();
-    XArrayList<pair<char, int>> freqList;
-
-    for (int i = 0; i < keys.size(); ++i) {
-        char c = keys.get(i);
-        int freq = freqMap.get(c);
-        freqList.add({c, freq});
+    liveHistogram.clear();
+    if (threadCount > 1 && invManager->size() > 1) {
+        int chunks = threadCount;
+        int products = invManager->size();
+        CharHistogram<4>* partial = new CharHistogram<4>[chunks];
+        parallelFor(chunks, threadCount, [&](int c) {
+            countFrequencies(partial[c], (int)((long long)products * c / chunks), (int)((long long)products * (c + 1) / chunks));
+        });
+        for (int c = 0; c < chunks; ++c) liveHistogram.merge(partial[c]);
+        delete[] partial;
+    } else {
+        countFrequencies(liveHistogram);
     }
 
-    for (int i = 1; i < freqList.size(); i++) {
-        pair<char, int> current = freqList.get(i);
-        int j = i - 1;
-        
-        while (j >= 0 && freqList.get(j).first > current.first) {
-            j--;
-        }
-        
-        if (j < i - 1) {
-            freqList.add(j + 1, current);
-            freqList.removeAt(i + 1);
-        }
-    }
+    canonicalCodes = canonical;
+    histogramLive = true;
+    buildFromHistogram();
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::buildFromHistogram()
+{
+    XArrayList<pair<char, int>> freqList;
+    liveHistogram.toFreqList(freqList);
 
     HuffmanTree<treeOrder>* oldTree = this->tree;
     this->tree = nullptr; 
@@ -290,148 +1214,1012 @@ void InventoryCompressor<treeOrder>::buildHuffman()
         delete oldTree;
     }
 
-    this->tree->build(freqList);
+    if (maxCodeLength > 0) {
+        this->tree->buildLengthLimited(freqList, maxCodeLength);
+    } else {
+        this->tree->buildTwoQueue(freqList);
+    }
+    if (canonicalCodes && maxCodeLength <= 0) {
+        XArrayList<pair<char, int>> lengths;
+        this->tree->codeLengths(lengths);
+        this->tree->buildFromCodeLengths(lengths);
+    }
     xMap<char, string>* prevTable = this->huffmanTable;
     this->huffmanTable = nullptr;
     
     this->huffmanTable = new xMap<char, string>(&charHashFunc);
     this->tree->generateCodes(*this->huffmanTable);
+    rebuildCodeTable();
     
     if (prevTable != nullptr) {
         delete prevTable;
     }
+
+    double cost, entropy;
+    codeCost(cost, entropy);
+    builtRatio = (entropy > 0) ? cost / entropy : 0;
+    ++version;
 }
 
 template <int treeOrder>
-void InventoryCompressor<treeOrder>::printHuffmanTable() {
+void InventoryCompressor<treeOrder>::rebuildCodeTable()
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    for (int c = 0; c < 256; ++c) {
+        codeTable[c].bits = 0;
+        codeTable[c].length = -1;
+        codeTable[c].textOffset = 0;
+    }
+    codeText.clear();
+
     DLinkedList<char> keys = huffmanTable->keys();
-    for (char chars : keys) {
-        std::cout << "'" << chars << "' : " << huffmanTable->get(chars) << std::endl;
+    for (char symbol : keys) {
+        const std::string& code = huffmanTable->get(symbol);
+        CodeEntry& entry = codeTable[(unsigned char)symbol];
+        entry.length = (int)code.length();
+        entry.textOffset = (int)codeText.length();
+        codeText += code;
+        if (entry.length * digitBits <= 64) {
+            for (char c : code) {
+                int digit = (c <= '9') ? (c - '0') : (c - 'a' + 10);
+                entry.bits = (entry.bits << digitBits) | (unsigned long long)digit;
+            }
+        }
     }
 }
 
+/*
+ * packCode: append one code to the bit writer (word, wordBits). The word
+ * never holds more than 7 pending bits between codes, so a code of up to 56
+ * bits is a single shift/OR; every completed byte goes to emit.
+ */
 template <int treeOrder>
-std::string InventoryCompressor<treeOrder>::productToString(const List1D<InventoryAttribute> &attributes, const std::string &name)
+template <class ByteSink>
+void InventoryCompressor<treeOrder>::packCode(const CodeEntry &entry, unsigned long long &word, int &wordBits, ByteSink emit)
 {
-    std::ostringstream result;
-    result << name << ":";
-
-    int count = attributes.size();
-    int index = 0;
-    while (index < count) {
-        const InventoryAttribute& attr = attributes.get(index);
-        result << "(" << attr.name << ": " << std::fixed << std::setprecision(6) << attr.value << ")";
-        if (index < count - 1) { result << ", ";}
-        ++index;
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    int codeBits = entry.length * digitBits;
+    if (codeBits <= 56) {
+        word = (word << codeBits) | entry.bits;
+        wordBits += codeBits;
+        while (wordBits >= 8) {
+            wordBits -= 8;
+            emit((unsigned char)(word >> wordBits));
+        }
+        return;
+    }
+    // long code: feed it digit by digit from its text
+    const char* digit = codeText.data() + entry.textOffset;
+    for (int i = 0; i < entry.length; ++i) {
+        int value = (digit[i] <= '9') ? (digit[i] - '0') : (digit[i] - 'a' + 10);
+        word = (word << digitBits) | (unsigned long long)value;
+        wordBits += digitBits;
+        if (wordBits >= 8) {
+            wordBits -= 8;
+            emit((unsigned char)(word >> wordBits));
+        }
+    }
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::symbolNotFound(char c)
+{
+    throw std::runtime_error("key (" + std::string(1, c) + ") is not found");
+}
+
+template <int treeOrder>
+template <int lanes>
+void InventoryCompressor<treeOrder>::countFrequencies(CharHistogram<lanes> &histogram, int first, int last)
+{
+    const size_t flushSize = 1 << 16;
+    if (last < 0 || last > invManager->size()) {
+        last = invManager->size();
+    }
+
+    std::string buffer;
+    buffer.reserve(flushSize + 1024);
+    for (int i = (first > 0 ? first : 0); i < last; ++i) {
+        appendProduct(i, buffer);
+        if (buffer.size() >= flushSize) {
+            histogram.add(buffer);
+            buffer.clear();
+        }
+    }
+    histogram.add(buffer);
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::setThreadCount(int threads)
+{
+    this->threadCount = (threads > 0) ? threads : hardwareThreads();
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::setMaxCodeLength(int maxLength)
+{
+    this->maxCodeLength = (maxLength > 0) ? maxLength : 0;
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::codebookHeader()
+{
+    XArrayList<pair<char, int>> lengths;
+    tree->codeLengths(lengths);
+
+    std::string header;
+    header.reserve(3 + 2 * lengths.size());
+    header.push_back((char)treeOrder);
+    header.push_back((char)(lengths.size() >> 8));
+    header.push_back((char)(lengths.size() & 0xff));
+    for (int i = 0; i < lengths.size(); ++i) {
+        header.push_back(lengths.get(i).first);
+        header.push_back((char)lengths.get(i).second);
+    }
+    return header;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::loadCodebook(const std::string &header)
+{
+    if (header.length() < 3 || (unsigned char)header[0] != treeOrder) {
+        throw std::runtime_error("Invalid codebook header");
+    }
+    int count = ((unsigned char)header[1] << 8) | (unsigned char)header[2];
+    if (count > 256 || header.length() != 3 + 2 * (size_t)count) {
+        throw std::runtime_error("Invalid codebook header");
+    }
+
+    XArrayList<pair<char, int>> lengths;
+    for (int i = 0; i < count; ++i) {
+        lengths.add({header[3 + 2 * i], (unsigned char)header[4 + 2 * i]});
+    }
+
+    // build aside: a rejected header must leave the current tree and tables in step
+    HuffmanTree<treeOrder>* loaded = new HuffmanTree<treeOrder>();
+    try {
+        loaded->buildFromCodeLengths(lengths);
+    } catch (const std::runtime_error&) {
+        delete loaded;
+        throw std::runtime_error("Invalid codebook header");
+    }
+    delete this->tree;
+    this->tree = loaded;
+
+    xMap<char, string>* prevTable = this->huffmanTable;
+    this->huffmanTable = new xMap<char, string>(&charHashFunc);
+    this->tree->generateCodes(*this->huffmanTable);
+    rebuildCodeTable();
+    delete prevTable;
+
+    // the codebook came from elsewhere: no histogram behind it to maintain
+    histogramLive = false;
+    ++version;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::printHuffmanTable() {
+    DLinkedList<char> keys = huffmanTable->keys();
+    for (char chars : keys) {
+        std::cout << "'" << chars << "' : " << huffmanTable->get(chars) << std::endl;
+    }
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::productToString(const List1D<InventoryAttribute> &attributes, const std::string &name)
+{
+    std::string result = name;
+    result += ':';
+
+    int count = attributes.size();
+    for (int index = 0; index < count; ++index) {
+        appendAttribute(attributes.at(index), result);
+        if (index < count - 1) { result += ", "; }
+    }
+
+    return result;
+}
+
+/*
+ * Same text as productToString, appended to out: "(name: value)" with the
+ * value in fixed notation, 6 decimals, rounded from the exact binary value
+ * like std::fixed << std::setprecision(6).
+ */
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::appendAttribute(const InventoryAttribute &attr, std::string &out)
+{
+    out += '(';
+    out += attr.name;
+    out += ": ";
+    appendValue(attr.value, out);
+    out += ')';
+}
+
+/*
+ * Fast path: scale by 1e6 and round to an integer. The scaled product is off
+ * by at most half an ulp, so the rounding is exact unless it lands within an
+ * ulp of a .5 tie; those (and huge / non-finite values) go to std::to_chars.
+ */
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::appendValue(double value, std::string &out)
+{
+    double magnitude = std::fabs(value);
+    if (magnitude < 1e9) {
+        double scaled = magnitude * 1e6;
+        double whole = std::floor(scaled);
+        double fraction = scaled - whole;
+        if (std::fabs(fraction - 0.5) > scaled * 0x1p-52) {
+            unsigned long long units = (unsigned long long)whole + (fraction > 0.5 ? 1 : 0);
+            char digits[24];
+            int n = 0;
+            do {
+                digits[n++] = (char)('0' + units % 10);
+                units /= 10;
+            } while (units != 0 || n < 7);
+
+            if (std::signbit(value)) out += '-';
+            while (n > 6) out += digits[--n];
+            out += '.';
+            while (n > 0) out += digits[--n];
+            return;
+        }
+    }
+
+    char digits[400];
+    std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6);
+    out.append(digits, written.ptr);
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::appendProduct(int index, std::string &out)
+{
+    if (serializationMode == BINARY_SERIALIZATION) {
+        appendBinaryProduct(invManager->getProductNameRef(index), invManager->getAttributeCount(index),
+                            [&](int a) -> const InventoryAttribute& { return invManager->getAttribute(index, a); }, out);
+        return;
+    }
+
+    out += invManager->getProductNameRef(index);
+    out += ':';
+
+    int count = invManager->getAttributeCount(index);
+    for (int a = 0; a < count; ++a) {
+        appendAttribute(invManager->getAttribute(index, a), out);
+        if (a < count - 1) { out += ", "; }
     }
-
-    return result.str();
 }
 
 template <int treeOrder>
 std::string InventoryCompressor<treeOrder>::encodeHuffman(const List1D<InventoryAttribute> &attributes, const std::string &name)
 {
-    std::string str = productToString(attributes, name);
+    std::string str = serializeProduct(attributes, name);
+
+    size_t digits = 0;
+    for (char c : str) {
+        const CodeEntry& entry = codeTable[(unsigned char)c];
+        if (entry.length < 0) symbolNotFound(c);
+        digits += entry.length;
+    }
+
     std::string code;
+    code.reserve(digits);
+    const char* text = codeText.data();
     for (char c : str) {
-        if (!huffmanTable->containsKey(c)) {
-            throw std::runtime_error("key (" + std::string(1, c) + ") is not found");
-        }
-        code += huffmanTable->get(c);
+        const CodeEntry& entry = codeTable[(unsigned char)c];
+        code.append(text + entry.textOffset, entry.length);
     }
     return code;
 }
 
+template <int treeOrder>
+int InventoryCompressor<treeOrder>::encodeHuffman(const List1D<InventoryAttribute> &attributes, const std::string &name, unsigned char *buffer, int bufferSize)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    std::string str = serializeProduct(attributes, name);
+
+    long long bitCount = 0;
+    for (char c : str) {
+        const CodeEntry& entry = codeTable[(unsigned char)c];
+        if (entry.length < 0) symbolNotFound(c);
+        bitCount += (long long)entry.length * digitBits;
+    }
+    if ((bitCount + 7) / 8 > bufferSize) {
+        throw std::out_of_range("Buffer is too small!");
+    }
+
+    unsigned long long word = 0;
+    int wordBits = 0;
+    int bytePos = 0;
+    for (char c : str) {
+        packCode(codeTable[(unsigned char)c], word, wordBits, [&](unsigned char byte) { buffer[bytePos++] = byte; });
+    }
+    if (wordBits > 0) {
+        buffer[bytePos++] = (unsigned char)(word << (8 - wordBits));
+    }
+    return (int)bitCount;
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::decodeHuffman(const unsigned char *buffer, int bitCount, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    if (buffer == nullptr || bitCount < 0 || bitCount % digitBits != 0) {
+        attributesOutput = List1D<InventoryAttribute>();
+        nameOutput = "";
+        return "\\x00";
+    }
+
+    std::string code;
+    code.reserve(bitCount / digitBits);
+    const int mask = (1 << digitBits) - 1;
+    for (int bitPos = 0; bitPos < bitCount; bitPos += digitBits) {
+        // a digit never straddles more than two bytes (digitBits <= 4)
+        int byteIdx = bitPos >> 3;
+        int window = buffer[byteIdx] << 8;
+        if (((bitPos & 7) + digitBits) > 8) window |= buffer[byteIdx + 1];
+        int digit = (window >> (16 - (bitPos & 7) - digitBits)) & mask;
+        code.push_back((digit < 10) ? ('0' + digit) : ('a' + (digit - 10)));
+    }
+    return decodeHuffman(code, attributesOutput, nameOutput);
+}
+
 template <int treeOrder>
 std::string InventoryCompressor<treeOrder>::decodeHuffman(const std::string &huffmanCode, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
-{   
+{
+    if (serializationMode == BINARY_SERIALIZATION) {
+        if (!parseBinaryProduct(tree->decode(huffmanCode), attributesOutput, nameOutput)) {
+            attributesOutput = List1D<InventoryAttribute>();
+            nameOutput = "";
+            return "\\x00";
+        }
+        return productToString(attributesOutput, nameOutput);
+    }
+    return parseProduct(tree->decode(huffmanCode), attributesOutput, nameOutput);
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::parseProduct(const std::string &decoded, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
+    switch (parseText(decoded, attributesOutput, nameOutput)) {
+    case PARSE_OK:
+        return decoded;
+    case PARSE_EMPTY:
+        return "";
+    default:
+        return "\\x00";
+    }
+}
+
+template <int treeOrder>
+typename InventoryCompressor<treeOrder>::ParseOutcome
+InventoryCompressor<treeOrder>::parseText(std::string_view decoded, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
     attributesOutput = List1D<InventoryAttribute>();
-    nameOutput = "";
+    nameOutput.clear();
 
-    std::string decoded = tree->decode(huffmanCode);
-    if (decoded.find("\\x00") != std::string::npos)  return "\\x00";
+    if (decoded.find("\\x00") != std::string_view::npos) return PARSE_INVALID;
 
     size_t nameDelimiter = decoded.find(':');
-    if (nameDelimiter == std::string::npos) return "\\x00";
+    if (nameDelimiter == std::string_view::npos) return PARSE_INVALID;
 
-    nameOutput = decoded.substr(0, nameDelimiter);
-    if (nameOutput.empty()) return "";
+    nameOutput.assign(decoded.data(), nameDelimiter);
+    if (nameOutput.empty()) return PARSE_EMPTY;
 
-    size_t firstAttrPos = decoded.find('(', nameDelimiter);
-    
-    if (firstAttrPos == std::string::npos) {
-        if (nameDelimiter != decoded.length() - 1)
-            return "";
-            
-        return decoded; 
+    size_t openParen = decoded.find('(', nameDelimiter);
+    if (openParen == std::string_view::npos) {
+        return (nameDelimiter == decoded.length() - 1) ? PARSE_OK : PARSE_EMPTY;
     }
-    
-    std::string attrPart = decoded.substr(nameDelimiter + 1);
-    size_t pos = 0;
-    
-    while (pos < attrPart.length()) {
-        size_t openParen = attrPart.find('(', pos);
-        if (openParen == std::string::npos)
-            break;
-            
-        size_t closeParen = attrPart.find(')', openParen);
-        if (closeParen == std::string::npos)
-            return ""; 
-            
-        std::string attrStr = attrPart.substr(openParen + 1, closeParen - openParen - 1);
-        
-        enum ParseState { KEY_SECTION, VALUE_SECTION };
-        ParseState state = KEY_SECTION;
-        
-        std::string attributeName;
-        std::string attributeValue;
-        
-        for (size_t i = 0; i < attrStr.length(); i++) {
-            char currentChar = attrStr[i];
-            
-            if (currentChar == ':' && state == KEY_SECTION) {
-                state = VALUE_SECTION;
-                attributeName = attributeName.substr(0, attributeName.find_last_not_of(" \t") + 1);
-                continue;
-            }
-            
-            if (state == KEY_SECTION) {
-                attributeName += currentChar;
+
+    for (; openParen != std::string_view::npos; openParen = decoded.find('(', openParen)) {
+        size_t closeParen = decoded.find(')', openParen);
+        if (closeParen == std::string_view::npos) return PARSE_EMPTY;
+
+        // "(key: value)": key ends at the first ':' (trailing blanks dropped);
+        // without a ':' the whole text is the key and the value is missing
+        std::string_view attr = decoded.substr(openParen + 1, closeParen - openParen - 1);
+        size_t colon = attr.find(':');
+        std::string_view key = attr.substr(0, colon);
+        std::string_view value;
+        if (colon != std::string_view::npos) {
+            size_t last = key.find_last_not_of(" \t");
+            key = key.substr(0, (last == std::string_view::npos) ? 0 : last + 1);
+            value = attr.substr(colon + 1);
+        }
+        if (key.empty()) return PARSE_OK;
+
+        double numericValue;
+        if (!parseNumber(value, numericValue)) return PARSE_EMPTY;
+        attributesOutput.add(InventoryAttribute(std::string(key), numericValue));
+
+        openParen = closeParen + 1;
+    }
+    return PARSE_OK;
+}
+
+template <int treeOrder>
+bool InventoryCompressor<treeOrder>::parseNumber(std::string_view text, double &value)
+{
+    // accept exactly what "stream >> double" does: leading whitespace, an
+    // optional sign, and a decimal number; trailing text is ignored, except
+    // that a dangling exponent ("1e", "2E+") fails
+    const char* first = text.data();
+    const char* last = first + text.length();
+    while (first < last && std::isspace((unsigned char)*first)) ++first;
+    const char* digits = first;
+    if (first < last && *first == '+') digits = ++first;
+    else if (first < last && *first == '-') digits = first + 1;
+    if (digits == last || !(std::isdigit((unsigned char)*digits) || *digits == '.')) return false;
+
+    std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        // overflow fails and underflow yields the tiny value: leave it to the stream
+        std::istringstream stream{std::string(text)};
+        stream >> value;
+        return !stream.fail();
+    }
+    if (result.ec != std::errc()) return false;
+    if (result.ptr == last || (*result.ptr != 'e' && *result.ptr != 'E')) return true;
+    // stopped at an 'e': fine after a complete exponent, a dangling one otherwise
+    for (const char* c = first; c < result.ptr; ++c) {
+        if (*c == 'e' || *c == 'E') return true;
+    }
+    return false;
+}
+
+
+/*
+ * encodeRange: pack products [first, last) into data (replacing it) from bit
+ * 0; productEnds[k] receives the end bit of product first + k. Returns the
+ * number of bits written.
+ */
+template <int treeOrder>
+long long InventoryCompressor<treeOrder>::encodeRange(int first, int last, std::string &data, long long *productEnds)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    data.clear();
+
+    std::string text;
+    unsigned long long word = 0;
+    int wordBits = 0;
+    long long bitPos = 0;
+    auto emit = [&](unsigned char byte) { data.push_back((char)byte); };
+
+    for (int i = first; i < last; ++i) {
+        text.clear();
+        appendProduct(i, text);
+        for (char c : text) {
+            const CodeEntry& entry = codeTable[(unsigned char)c];
+            if (entry.length < 0) symbolNotFound(c);
+            packCode(entry, word, wordBits, emit);
+            bitPos += (long long)entry.length * digitBits;
+        }
+        productEnds[i - first] = bitPos;
+    }
+    if (wordBits > 0) {
+        emit((unsigned char)(word << (8 - wordBits)));
+    }
+    return bitPos;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::encodeAll(HuffmanBatch &batch)
+{
+    batch.data.clear();
+    batch.bitOffsets = List1D<long long>();
+    batch.bitOffsets.add(0);
+
+    int products = invManager->size();
+    if (threadCount > 1 && products > 1) {
+        encodeAllParallel(batch);
+        return;
+    }
+
+    long long* ends = new long long[products > 0 ? products : 1];
+    try {
+        encodeRange(0, products, batch.data, ends);
+    } catch (...) {
+        delete[] ends;
+        batch.data.clear();
+        batch.bitOffsets = List1D<long long>();
+        throw;
+    }
+    for (int i = 0; i < products; ++i) batch.bitOffsets.add(ends[i]);
+    delete[] ends;
+}
+
+/*
+ * encodeAllParallel: every block (row range) is packed on its own from bit 0,
+ * then shifted into place at its global bit offset. Bytes strictly inside a
+ * block's span belong to it alone and are written by its worker; the two
+ * edge bytes may be shared with the neighbours, so they are OR-ed in
+ * afterwards on the calling thread.
+ */
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::encodeAllParallel(HuffmanBatch &batch)
+{
+    int products = invManager->size();
+    int blocks = threadCount * 4;
+    if (blocks > products) blocks = products;
+
+    std::string* blockData = new std::string[blocks];
+    long long* blockBits = new long long[blocks + 1];
+    long long* ends = new long long[products];
+    int* blockFirst = new int[blocks + 1];
+    for (int b = 0; b <= blocks; ++b) blockFirst[b] = (int)((long long)products * b / blocks);
+
+    try {
+        parallelFor(blocks, threadCount, [&](int b) {
+            blockBits[b] = encodeRange(blockFirst[b], blockFirst[b + 1], blockData[b], ends + blockFirst[b]);
+        });
+    } catch (...) {
+        delete[] blockData; delete[] blockBits; delete[] ends; delete[] blockFirst;
+        batch.data.clear();
+        batch.bitOffsets = List1D<long long>();
+        throw;
+    }
+
+    // exclusive prefix sum: blockBits[b] becomes the block's first global bit
+    long long total = 0;
+    for (int b = 0; b < blocks; ++b) {
+        long long bits = blockBits[b];
+        blockBits[b] = total;
+        total += bits;
+    }
+    blockBits[blocks] = total;
+
+    batch.data.assign((size_t)((total + 7) / 8), '\0');
+    unsigned char* out = reinterpret_cast<unsigned char*>(&batch.data[0]);
+    unsigned char* edges = new unsigned char[2 * blocks];
+
+    parallelFor(blocks, threadCount, [&](int b) {
+        long long start = blockBits[b], length = blockBits[b + 1] - start;
+        edges[2 * b] = edges[2 * b + 1] = 0;
+        if (length == 0) return;
+
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(blockData[b].data());
+        long long firstByte = start >> 3, lastByte = (start + length - 1) >> 3;
+        int shift = (int)(start & 7);
+        for (long long j = firstByte; j <= lastByte; ++j) {
+            long long k = j - firstByte;
+            unsigned char value;
+            if (shift == 0) {
+                value = in[k];
             } else {
-                attributeValue += currentChar;
+                value = (unsigned char)((k < (long long)blockData[b].size() ? in[k] >> shift : 0) |
+                                        (k > 0 ? in[k - 1] << (8 - shift) : 0));
             }
+            if (j == firstByte) edges[2 * b] = value;
+            else if (j == lastByte) edges[2 * b + 1] = value;
+            else out[j] = value;
         }
-        
-        if (attributeName.empty()) {
-            return decoded;
+    });
+
+    for (int b = 0; b < blocks; ++b) {
+        if (blockBits[b + 1] == blockBits[b]) continue;
+        out[blockBits[b] >> 3] |= edges[2 * b];
+        long long lastByte = (blockBits[b + 1] - 1) >> 3;
+        if (lastByte != (blockBits[b] >> 3)) out[lastByte] |= edges[2 * b + 1];
+    }
+
+    for (int b = 0; b < blocks; ++b) {
+        for (int i = blockFirst[b]; i < blockFirst[b + 1]; ++i) {
+            batch.bitOffsets.add(blockBits[b] + ends[i]);
         }
-        
-        while (!attributeValue.empty() && (attributeValue[0] == ' ' || attributeValue[0] == '\t')) {
-            attributeValue.erase(0, 1);
+    }
+
+    delete[] edges;
+    delete[] blockData;
+    delete[] blockBits;
+    delete[] ends;
+    delete[] blockFirst;
+}
+
+template <int treeOrder>
+int InventoryCompressor<treeOrder>::decodeAll(const HuffmanBatch &batch, List2D<InventoryAttribute> &attributesOutput, List1D<std::string> &namesOutput)
+{
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(batch.data.data());
+    std::string text;
+    List1D<InventoryAttribute> row;
+    std::string productName;
+    int clean = 0;
+
+    for (int i = 0; i < batch.size(); ++i) {
+        long long first = batch.bitOffsets.at(i);
+        text.clear();
+        if (tree->decodePacked(data, first, batch.bitOffsets.at(i + 1) - first, text)) {
+            if (parseRecord(text, row, productName)) ++clean;
+        } else {
+            row = List1D<InventoryAttribute>();
+            productName = "";
         }
-        
-        try {
-            double numericValue = 0.0;
-            std::stringstream ss(attributeValue);
-            ss >> numericValue;
-            
-            if (ss.fail()) {
-                throw std::runtime_error("Invalid format");
-            }
-            
-            attributesOutput.add(InventoryAttribute(attributeName, numericValue));
-        } catch (...) {
-            return "";
+        attributesOutput.setRow(attributesOutput.rows(), row);
+        namesOutput.add(productName);
+    }
+    return clean;
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::encodeContainer(int syncInterval)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    if (syncInterval < 1) syncInterval = 1;
+
+    HuffmanBatch batch;
+    encodeAll(batch);
+    int products = batch.size();
+    int blocks = (products + syncInterval - 1) / syncInterval;
+
+    std::string lengths;
+    std::string syncTable;
+    for (int i = 0; i < products; ++i) {
+        if (i % syncInterval == 0) {
+            ByteCodec::appendUint(syncTable, (unsigned long long)i, 4);
+            ByteCodec::appendUint(syncTable, (unsigned long long)(batch.bitOffsets.at(i) / digitBits), 8);
+            ByteCodec::appendUint(syncTable, (unsigned long long)lengths.size(), 4);
         }
-        
-        pos = closeParen + 1;
-        
-        if (pos < attrPart.length() && attrPart[pos] == ',') {
-            pos++;
-            while (pos < attrPart.length() && attrPart[pos] == ' ')
-                pos++;
+        ByteCodec::appendVarint(lengths, (unsigned long long)((batch.bitOffsets.at(i + 1) - batch.bitOffsets.at(i)) / digitBits));
+    }
+
+    std::string container = "HUFB";
+    container.push_back((char)treeOrder);
+    ByteCodec::appendUint(container, (unsigned long long)products, 4);
+    ByteCodec::appendUint(container, (unsigned long long)syncInterval, 4);
+    ByteCodec::appendUint(container, (unsigned long long)lengths.size(), 4);
+    container.reserve(container.size() + 16 * (size_t)blocks + lengths.size() + batch.data.size());
+    container += syncTable;
+    container += lengths;
+    container += batch.data;
+    return container;
+}
+
+template <int treeOrder>
+int InventoryCompressor<treeOrder>::decodeContainer(const std::string &container, List2D<InventoryAttribute> &attributesOutput, List1D<std::string> &namesOutput)
+{
+    const int digitBits = HuffmanTree<treeOrder>::bitsPerDigit;
+    const size_t headerSize = 17, entrySize = 16;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(container.data());
+
+    if (container.size() < headerSize || container.compare(0, 4, "HUFB") != 0 || in[4] != treeOrder) {
+        throw std::runtime_error("Invalid container");
+    }
+    unsigned long long products = ByteCodec::readUint(in + 5, 4);
+    unsigned long long syncInterval = ByteCodec::readUint(in + 9, 4);
+    unsigned long long lengthsSize = ByteCodec::readUint(in + 13, 4);
+    // every product has at least one length byte: products is bounded by the
+    // lengths section before it sizes anything
+    if (syncInterval == 0 || products > 0x7fffffff || products > lengthsSize) {
+        throw std::runtime_error("Invalid container");
+    }
+    unsigned long long blocks = (products + syncInterval - 1) / syncInterval;
+    if (headerSize + blocks * entrySize + lengthsSize > container.size()) {
+        throw std::runtime_error("Invalid container");
+    }
+
+    const unsigned char* syncTable = in + headerSize;
+    const unsigned char* lengths = syncTable + blocks * entrySize;
+    const unsigned char* data = lengths + lengthsSize;
+    long long dataBits = (long long)(container.size() - (data - in)) * 8;
+
+    // a block's entry must sit where the interval puts it, with offsets in range
+    for (unsigned long long b = 0; b < blocks; ++b) {
+        const unsigned char* entry = syncTable + b * entrySize;
+        if (ByteCodec::readUint(entry, 4) != b * syncInterval ||
+            ByteCodec::readUint(entry + 4, 8) > (unsigned long long)dataBits / digitBits ||
+            ByteCodec::readUint(entry + 12, 4) > lengthsSize) {
+            throw std::runtime_error("Invalid container");
         }
     }
-    
+
+    int count = (int)products;
+    List1D<InventoryAttribute>* rows = new List1D<InventoryAttribute>[count > 0 ? count : 1];
+    std::string* names = new std::string[count > 0 ? count : 1];
+    int* clean = new int[blocks > 0 ? blocks : 1];
+
+    tree->prepareDecode();
+    parallelFor((int)blocks, threadCount, [&](int b) {
+        const unsigned char* entry = syncTable + (unsigned long long)b * entrySize;
+        long long bit = (long long)ByteCodec::readUint(entry + 4, 8) * digitBits;
+        const unsigned char* length = lengths + ByteCodec::readUint(entry + 12, 4);
+        const unsigned char* lengthEnd = (b + 1 < (int)blocks) ? lengths + ByteCodec::readUint(entry + entrySize + 12, 4) : data;
+        int first = (int)(b * syncInterval);
+        int last = (int)((unsigned long long)(first + syncInterval) < products ? first + syncInterval : products);
+
+        std::string text;
+        clean[b] = 0;
+        for (int i = first; i < last; ++i) {
+            unsigned long long digits;
+            if (!ByteCodec::readVarint(length, lengthEnd, digits) || digits > (unsigned long long)(dataBits - bit) / digitBits) {
+                break; // the rest of this block stays empty
+            }
+            long long bits = (long long)digits * digitBits;
+            text.clear();
+            if (tree->decodePacked(data, bit, bits, text) && parseRecord(text, rows[i], names[i])) {
+                clean[b]++;
+            } else {
+                rows[i] = List1D<InventoryAttribute>();
+                names[i] = "";
+            }
+            bit += bits;
+        }
+    });
+
+    int decoded = 0;
+    for (unsigned long long b = 0; b < blocks; ++b) decoded += clean[b];
+    for (int i = 0; i < count; ++i) {
+        attributesOutput.setRow(attributesOutput.rows(), rows[i]);
+        namesOutput.add(names[i]);
+    }
+
+    delete[] rows;
+    delete[] names;
+    delete[] clean;
     return decoded;
 }
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::setSerializationMode(SerializationMode mode)
+{
+    this->serializationMode = mode;
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::serializeProduct(const List1D<InventoryAttribute> &attributes, const std::string &name)
+{
+    if (serializationMode != BINARY_SERIALIZATION) {
+        return productToString(attributes, name);
+    }
+    std::string record;
+    appendBinaryProduct(name, attributes.size(), [&](int a) -> const InventoryAttribute& { return attributes.at(a); }, record);
+    return record;
+}
+
+template <int treeOrder>
+bool InventoryCompressor<treeOrder>::parseRecord(const std::string &decoded, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
+    if (serializationMode != BINARY_SERIALIZATION) {
+        return parseText(decoded, attributesOutput, nameOutput) == PARSE_OK;
+    }
+    if (parseBinaryProduct(decoded, attributesOutput, nameOutput)) return true;
+    attributesOutput = List1D<InventoryAttribute>();
+    nameOutput = "";
+    return false;
+}
+
+// Attribute names in order of first appearance in the inventory
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::collectAttributeNames()
+{
+    attributeIds->clear();
+    attributeNames.clear();
+    for (int i = 0; i < invManager->size(); ++i) {
+        int count = invManager->getAttributeCount(i);
+        for (int a = 0; a < count; ++a) {
+            const std::string& name = invManager->getAttribute(i, a).name;
+            bool added;
+            attributeIds->findOrPut(name, attributeNames.size(), &added);
+            if (added) attributeNames.add(name);
+        }
+    }
+}
+
+template <int treeOrder>
+int InventoryCompressor<treeOrder>::attributeId(const std::string &name)
+{
+    xMap<std::string, int>::Entry *entry = attributeIds->find(name);
+    if (entry == nullptr) {
+        throw std::runtime_error("attribute (" + name + ") is not found");
+    }
+    return entry->getValue();
+}
+
+template <int treeOrder>
+template <class AttributeAt>
+void InventoryCompressor<treeOrder>::appendBinaryProduct(const std::string &name, int attributeCount, AttributeAt attributeAt, std::string &out)
+{
+    ByteCodec::appendVarint(out, name.length());
+    out += name;
+    ByteCodec::appendVarint(out, (unsigned long long)attributeCount);
+    for (int a = 0; a < attributeCount; ++a) {
+        const InventoryAttribute& attr = attributeAt(a);
+        ByteCodec::appendVarint(out, (unsigned long long)attributeId(attr.name));
+        ByteCodec::appendValue(out, attr.value);
+    }
+}
+
+template <int treeOrder>
+bool InventoryCompressor<treeOrder>::parseBinaryProduct(const std::string &record, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
+    attributesOutput = List1D<InventoryAttribute>();
+    nameOutput = "";
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(record.data());
+    const unsigned char* end = in + record.size();
+    unsigned long long nameLength, count;
+    if (!ByteCodec::readVarint(in, end, nameLength) || nameLength > (unsigned long long)(end - in)) return false;
+    nameOutput.assign(reinterpret_cast<const char*>(in), (size_t)nameLength);
+    in += nameLength;
+    if (!ByteCodec::readVarint(in, end, count) || count > (unsigned long long)(end - in)) return false;
+
+    for (unsigned long long a = 0; a < count; ++a) {
+        unsigned long long id;
+        double value;
+        if (!ByteCodec::readVarint(in, end, id) || id >= (unsigned long long)attributeNames.size()) return false;
+        if (!ByteCodec::readValue(in, end, value)) return false;
+        attributesOutput.add(InventoryAttribute(attributeNames.get((int)id), value));
+    }
+    return in == end;
+}
+
+/*
+ * Attribute dictionary: [count: varint] then [length: varint][name] per
+ * attribute name, in id order.
+ */
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::attributeDictionary()
+{
+    std::string dictionary;
+    ByteCodec::appendVarint(dictionary, (unsigned long long)attributeNames.size());
+    for (int i = 0; i < attributeNames.size(); ++i) {
+        ByteCodec::appendVarint(dictionary, attributeNames.get(i).length());
+        dictionary += attributeNames.get(i);
+    }
+    return dictionary;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::loadAttributeDictionary(const std::string &dictionary)
+{
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(dictionary.data());
+    const unsigned char* end = in + dictionary.size();
+    unsigned long long count;
+    if (!ByteCodec::readVarint(in, end, count) || count > (unsigned long long)(end - in)) {
+        throw std::runtime_error("Invalid attribute dictionary");
+    }
+
+    XArrayList<std::string> names;
+    for (unsigned long long i = 0; i < count; ++i) {
+        unsigned long long length;
+        if (!ByteCodec::readVarint(in, end, length) || length > (unsigned long long)(end - in)) {
+            throw std::runtime_error("Invalid attribute dictionary");
+        }
+        names.add(std::string(reinterpret_cast<const char*>(in), (size_t)length));
+        in += length;
+    }
+    if (in != end) {
+        throw std::runtime_error("Invalid attribute dictionary");
+    }
+
+    attributeIds->clear();
+    attributeNames.clear();
+    for (int i = 0; i < names.size(); ++i) {
+        attributeIds->put(names.get(i), i);
+        attributeNames.add(names.get(i));
+    }
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::encodeAdaptive(const List1D<InventoryAttribute> &attributes, const std::string &name)
+{
+    std::string text = productToString(attributes, name);
+    std::string huffmanCode;
+    huffmanCode.reserve(text.length() * 4);
+    for (char c : text) {
+        adaptiveEncoder->encode(c, huffmanCode);
+    }
+    return huffmanCode;
+}
+
+template <int treeOrder>
+std::string InventoryCompressor<treeOrder>::decodeAdaptive(const std::string &huffmanCode, List1D<InventoryAttribute> &attributesOutput, std::string &nameOutput)
+{
+    std::string text;
+    const char* digit = huffmanCode.data();
+    const char* end = digit + huffmanCode.length();
+    while (digit < end) {
+        int symbol = adaptiveDecoder->decode(digit, end);
+        if (symbol < 0) {
+            attributesOutput = List1D<InventoryAttribute>();
+            nameOutput = "";
+            return "\\x00";
+        }
+        text.push_back((char)symbol);
+    }
+    return parseProduct(text, attributesOutput, nameOutput);
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::resetAdaptive()
+{
+    adaptiveEncoder->reset();
+    adaptiveDecoder->reset();
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::addProduct(const List1D<InventoryAttribute> &attributes, const std::string &name, int quantity)
+{
+    if (histogramLive && serializationMode == BINARY_SERIALIZATION) {
+        for (int a = 0; a < attributes.size(); ++a) {
+            const std::string& attributeName = attributes.at(a).name;
+            bool added;
+            attributeIds->findOrPut(attributeName, attributeNames.size(), &added);
+            if (added) attributeNames.add(attributeName);
+        }
+    }
+    invManager->addProduct(attributes, name, quantity);
+    if (!histogramLive) return;
+
+    std::string serialized;
+    appendProduct(invManager->size() - 1, serialized);
+    liveHistogram.add(serialized);
+    histogramChanged(serialized);
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::removeProduct(int index)
+{
+    std::string serialized;
+    if (histogramLive && index >= 0 && index < invManager->size()) {
+        appendProduct(index, serialized);
+    }
+    invManager->removeProduct(index);
+    if (!histogramLive) return;
+
+    liveHistogram.remove(serialized);
+    histogramChanged("");
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::updateQuantity(int index, int newQuantity)
+{
+    invManager->updateQuantity(index, newQuantity);
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::setRebuildThreshold(double threshold)
+{
+    rebuildThreshold = threshold;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::histogramChanged(const std::string &serialized)
+{
+    for (char c : serialized) {
+        if (codeTable[(unsigned char)c].length < 0) {
+            buildFromHistogram();
+            return;
+        }
+    }
+    if (estimatedInefficiency() > rebuildThreshold) {
+        buildFromHistogram();
+    }
+}
+
+template <int treeOrder>
+double InventoryCompressor<treeOrder>::estimatedInefficiency()
+{
+    if (!histogramLive || builtRatio <= 0) return 0;
+    double cost, entropy;
+    codeCost(cost, entropy);
+    return (entropy > 0) ? (cost / entropy) / builtRatio - 1 : 0;
+}
+
+template <int treeOrder>
+void InventoryCompressor<treeOrder>::codeCost(double &cost, double &entropy)
+{
+    // cost: digits to code the histogram with the current code;
+    // entropy: the base-treeOrder lower bound for any code
+    double total = 0;
+    cost = 0;
+    entropy = 0;
+    for (int c = 0; c < 256; ++c) {
+        double count = (double)liveHistogram.count((char)c);
+        if (count == 0) continue;
+        total += count;
+        cost += count * codeTable[c].length;
+        entropy -= count * std::log(count);
+    }
+    if (total > 0) {
+        entropy = (entropy + total * std::log(total)) / std::log((double)treeOrder);
+    }
+}
+
+#endif // INVENTORY_COMPRESSOR_H
@@ -0,0 +1,145 @@
+#ifndef TREE_ORDER_H
+#define TREE_ORDER_H
+
+#include <cmath>
+#include <type_traits>
+#include "inventory_compressor.h"
+
+/*
+ * Runtime choice of treeOrder.
+ *
+ * HuffmanTree / InventoryCompressor fix treeOrder at compile time; these
+ * helpers pick it from the data instead. One histogram is counted, a tree of
+ * every supported order (2..16) is built from it, and each is scored:
+ *  + bits: packed code size, digits * bitsPerDigit (the size encodeAll and
+ *      encodeContainer write), plus the codebookHeader
+ *  + lookups: decode-table steps to decode everything, digits / decodeChunk
+ *  + tableBytes: size of the lookup table decode builds (one row of
+ *      treeOrder^decodeChunk entries per internal node); a step into a table
+ *      that overflows L1 costs 1 + log2(1 + tableBytes / 32 KiB) steps
+ *  + cost: bits + decodeWeight * weighted lookups, the figure minimised
+ * decodeWeight prices one in-cache table step in bits: 0 picks the smallest
+ * output, larger values trade size for decode speed. Code length caps
+ * (setMaxCodeLength) are not modelled.
+ *
+ * withTreeOrder(order, visit) then runs visit(std::integral_constant<int, N>)
+ * for the chosen N, so a generic lambda reaches the matching instantiation:
+ *   withTreeOrder(choice.order, [&](auto order) {
+ *       InventoryCompressor<decltype(order)::value> compressor(&inventory);
+ *       ...
+ *   });
+ */
+struct TreeOrderEstimate {
+    int order;
+    double digits;
+    double bits;
+    double lookups;
+    double tableBytes;
+    double cost;
+};
+
+constexpr int minTreeOrder = 2;
+constexpr int maxTreeOrder = 16;
+
+template <int treeOrder>
+TreeOrderEstimate estimateTreeOrder(XArrayList<pair<char, int>>& freqList, double decodeWeight)
+{
+    HuffmanTree<treeOrder> tree;
+    tree.buildTwoQueue(freqList);
+    XArrayList<pair<char, int>> lengths;
+    tree.codeLengths(lengths);
+
+    // codeLengths is in canonical order, so match counts to symbols by value
+    int length[256] = {};
+    for (int i = 0; i < lengths.size(); ++i) {
+        length[(unsigned char)lengths.get(i).first] = lengths.get(i).second;
+    }
+
+    TreeOrderEstimate estimate;
+    estimate.order = treeOrder;
+    estimate.digits = 0;
+    for (int i = 0; i < freqList.size(); ++i) {
+        estimate.digits += (double)freqList.get(i).second * length[(unsigned char)freqList.get(i).first];
+    }
+    estimate.bits = estimate.digits * HuffmanTree<treeOrder>::bitsPerDigit + 8.0 * (3 + 2 * lengths.size());
+    estimate.lookups = estimate.digits / HuffmanTree<treeOrder>::decodeChunk;
+
+    int leaves = lengths.size();
+    int pads = (leaves > 1) ? (treeOrder - 1 - (leaves - 1) % (treeOrder - 1)) % (treeOrder - 1) : treeOrder - 1;
+    int states = (leaves > 0) ? (leaves + pads - 1) / (treeOrder - 1) : 0;
+    double span = 1;
+    for (int i = 0; i < HuffmanTree<treeOrder>::decodeChunk; ++i) span *= treeOrder;
+    estimate.tableBytes = states * span * (2 * sizeof(int) + HuffmanTree<treeOrder>::decodeChunk);
+
+    double stepCost = 1 + std::log2(1 + estimate.tableBytes / 32768);
+    estimate.cost = estimate.bits + decodeWeight * estimate.lookups * stepCost;
+    return estimate;
+}
+
+template <int treeOrder = minTreeOrder>
+void estimateTreeOrders(XArrayList<pair<char, int>>& freqList, double decodeWeight, TreeOrderEstimate* estimates)
+{
+    estimates[treeOrder - minTreeOrder] = estimateTreeOrder<treeOrder>(freqList, decodeWeight);
+    if constexpr (treeOrder < maxTreeOrder) {
+        estimateTreeOrders<treeOrder + 1>(freqList, decodeWeight, estimates);
+    }
+}
+
+/*
+ * chooseTreeOrder(freqList | histogram | inventory, decodeWeight, estimates):
+ * the lowest-cost order (ties go to the smaller order). When estimates is
+ * given it receives all maxTreeOrder - minTreeOrder + 1 scores, by order.
+ * The inventory overload counts the products as serialised in mode, with one
+ * buildHuffman pass of an order-2 compressor.
+ */
+inline TreeOrderEstimate chooseTreeOrder(XArrayList<pair<char, int>>& freqList, double decodeWeight = 2.0,
+                                         TreeOrderEstimate* estimates = nullptr)
+{
+    TreeOrderEstimate all[maxTreeOrder - minTreeOrder + 1];
+    estimateTreeOrders(freqList, decodeWeight, all);
+
+    int best = 0;
+    for (int i = 1; i <= maxTreeOrder - minTreeOrder; ++i) {
+        if (all[i].cost < all[best].cost) best = i;
+    }
+    if (estimates != nullptr) {
+        for (int i = 0; i <= maxTreeOrder - minTreeOrder; ++i) estimates[i] = all[i];
+    }
+    return all[best];
+}
+
+template <int lanes>
+TreeOrderEstimate chooseTreeOrder(const CharHistogram<lanes>& histogram, double decodeWeight = 2.0,
+                                  TreeOrderEstimate* estimates = nullptr)
+{
+    XArrayList<pair<char, int>> freqList;
+    histogram.toFreqList(freqList);
+    return chooseTreeOrder(freqList, decodeWeight, estimates);
+}
+
+inline TreeOrderEstimate chooseTreeOrder(InventoryManager* inventory, SerializationMode mode = TEXT_SERIALIZATION,
+                                         double decodeWeight = 2.0, TreeOrderEstimate* estimates = nullptr)
+{
+    // the serialised bytes do not depend on treeOrder: any instantiation counts them
+    InventoryCompressor<minTreeOrder> counter(inventory);
+    counter.setSerializationMode(mode);
+    counter.buildHuffman();
+    return chooseTreeOrder(counter.frequencyHistogram(), decodeWeight, estimates);
+}
+
+/*
+ * withTreeOrder(order, visit): visit(std::integral_constant<int, order>()),
+ * returning its result; throws std::out_of_range for an unsupported order.
+ */
+template <int treeOrder = minTreeOrder, class Visitor>
+auto withTreeOrder(int order, Visitor visit) -> decltype(visit(std::integral_constant<int, minTreeOrder>()))
+{
+    if (order == treeOrder) return visit(std::integral_constant<int, treeOrder>());
+    if constexpr (treeOrder < maxTreeOrder) {
+        return withTreeOrder<treeOrder + 1>(order, visit);
+    } else {
+        throw std::out_of_range("treeOrder is out of range!");
+    }
+}
+
+#endif // TREE_ORDER_H
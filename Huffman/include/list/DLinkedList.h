@@ -2,6 +2,7 @@
 #define DLINKEDLIST_H
 
 #include "list/IList.h"
+#include "util/poolAllocator.h"
 
 #include <sstream>
 #include <iostream>
@@ -22,11 +23,13 @@ protected:
     int count;
     bool (*itemEqual)(T &lhs, T &rhs);        // function pointer: test if two items (type: T&) are equal or not
     void (*deleteUserData)(DLinkedList<T> *); // function pointer: be called to remove items (if they are pointer type)
+    NodeAllocator *allocator;                 // where nodes (head and tail too) come from; 0: new / delete
 
 public:
     DLinkedList(
         void (*deleteUserData)(DLinkedList<T> *) = 0,
-        bool (*itemEqual)(T &, T &) = 0);
+        bool (*itemEqual)(T &, T &) = 0,
+        NodeAllocator *allocator = 0);
     DLinkedList(const DLinkedList<T> &list);
     DLinkedList<T> &operator=(const DLinkedList<T> &list);
     ~DLinkedList();
@@ -129,6 +132,23 @@ protected:
     }
     void copyFrom(const DLinkedList<T> &list);
     void removeInternalData();
+    template <class... Args>
+    Node *createNode(Args... args)
+    {
+        if (allocator == 0)
+            return new Node(args...);
+        return new (allocator->allocate(sizeof(Node))) Node(args...);
+    }
+    void destroyNode(Node *node)
+    {
+        if (allocator == 0)
+            delete node;
+        else
+        {
+            node->~Node();
+            allocator->release(node, sizeof(Node));
+        }
+    }
     Node *getPreviousNodeOf(int index);
 
     //////////////////////////////////////////////////////////////////////
@@ -197,7 +217,7 @@ public:
             Node *pNext = pNode->prev;
             if (removeItemData != 0)
                 removeItemData(pNode->data);
-            delete pNode;
+            pList->destroyNode(pNode);
             pNode = pNext;
             pList->count -= 1;
         }
@@ -264,7 +284,7 @@ public:
             if (removeItemData != nullptr)
                 removeItemData(nodeToRemove->data);
 
-            delete nodeToRemove;
+            pList->destroyNode(nodeToRemove);
             pList->count--;
         }
 
@@ -303,10 +323,12 @@ using List = DLinkedList<T>;
 template <class T>
 DLinkedList<T>::DLinkedList(
     void (*deleteUserData)(DLinkedList<T> *),
-    bool (*itemEqual)(T &, T &))
+    bool (*itemEqual)(T &, T &),
+    NodeAllocator *allocator)
 {
-    this->head = new Node();
-    this->tail = new Node();
+    this->allocator = allocator;
+    this->head = createNode();
+    this->tail = createNode();
     this->head->next = this->tail;
     this->tail->prev = this->head;
     this->count = 0;
@@ -317,8 +339,9 @@ DLinkedList<T>::DLinkedList(
 template <class T>
 DLinkedList<T>::DLinkedList(const DLinkedList<T> &list)
 {
-    this->head = new Node();
-    this->tail = new Node();
+    this->allocator = list.allocator;
+    this->head = createNode();
+    this->tail = createNode();
     this->head->next = this->tail;
     this->tail->prev = this->head;
     this->count = 0;
@@ -342,14 +365,14 @@ template <class T>
 DLinkedList<T>::~DLinkedList()
 {
     removeInternalData();
-    delete head;
-    delete tail;
+    destroyNode(head);
+    destroyNode(tail);
 }
 
 template <class T>
 void DLinkedList<T>::add(T e)
 {
-    Node *newNode = new Node(e, tail, tail->prev);
+    Node *newNode = createNode(e, tail, tail->prev);
     tail->prev->next = newNode;
     tail->prev = newNode;
     count++;
@@ -362,7 +385,7 @@ void DLinkedList<T>::add(int index, T e)
         throw std::out_of_range("Index is out of range!");
     
     Node *prevNode = getPreviousNodeOf(index);
-    Node *newNode = new Node(e, prevNode->next, prevNode);
+    Node *newNode = createNode(e, prevNode->next, prevNode);
     prevNode->next->prev = newNode;
     prevNode->next = newNode;
     count++;
@@ -408,7 +431,7 @@ T DLinkedList<T>::removeAt(int index)
     prevNode->next = nodeToRemove->next;
     nodeToRemove->next->prev = prevNode;
     
-    delete nodeToRemove;
+    destroyNode(nodeToRemove);
     count--;
     
     return data;
@@ -472,7 +495,7 @@ bool DLinkedList<T>::removeItem(T item, void (*removeItemData)(T))
             if (removeItemData != nullptr)
                 removeItemData(current->data);
                 
-            delete current;
+            destroyNode(current);
             count--;
             return true;
         }
@@ -546,7 +569,7 @@ void DLinkedList<T>::removeInternalData()
     Node *current = head->next;
     while (current != tail) {
         Node *next = current->next;
-        delete current;
+        destroyNode(current);
         current = next;
     }
 }
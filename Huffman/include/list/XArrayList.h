@@ -5,6 +5,7 @@
 #include <sstream>
 #include <iostream>
 #include <type_traits>
+#include <utility>
 using namespace std;
 
 template <class T>
@@ -281,10 +282,10 @@ template <class T>
 T XArrayList<T>::removeAt(int index)
 {
     checkIndex(index);
-    T removedItem = data[index];
+    T removedItem = std::move(data[index]);
 
     for (int i = index; i < count - 1; ++i)
-        data[i] = data[i + 1];
+        data[i] = std::move(data[i + 1]);
 
     count--;
     return removedItem;
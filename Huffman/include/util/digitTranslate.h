@@ -0,0 +1,117 @@
+#ifndef DIGITTRANSLATE_H
+#define DIGITTRANSLATE_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DIGITTRANSLATE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(DIGITTRANSLATE_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DIGITTRANSLATE_AVX2 1
+#include <immintrin.h>
+#endif
+
+/*
+ * translateDigits(digits, length, base, values): validate a run of code
+ * digits ('0'-'9', 'a'-'f', as HuffmanTree writes them) against the alphabet
+ * of a base-`base` code and store each digit's value (0..base-1) in
+ * values[0, length). Returns false if any character is not a digit below
+ * base; values is then unspecified.
+ *
+ * The whole run is checked in one pass with no branch per character: errors
+ * are OR-ed into a mask and tested once at the end. translateDigits picks the
+ * widest kernel the machine runs:
+ *  + AVX2: 32 digits per step (GCC/Clang on x86, chosen at run time, so no
+ *      -mavx2 is needed)
+ *  + SSE2: 16 digits per step (baseline on x86-64)
+ *  + scalar: a 256-entry table, also used for the tail of the vector kernels
+ */
+inline bool translateDigitsScalar(const char* digits, size_t length, int base, unsigned char* values)
+{
+    // 0xff for non-digits: always >= base
+    static const unsigned char table[256] = {
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,   0,  1,  2,  3,  4,  5,  6,  7,  8,  9,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255, 10, 11, 12, 13, 14, 15,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+        255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255 };
+
+    bool bad = false;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char value = table[(unsigned char)digits[i]];
+        bad |= value >= base;
+        values[i] = value;
+    }
+    return !bad;
+}
+
+#ifdef DIGITTRANSLATE_SSE2
+inline bool translateDigitsSSE2(const char* digits, size_t length, int base, unsigned char* values)
+{
+    // signed byte compares: bytes >= 0x80 are negative and fall outside both ranges
+    const __m128i zeroBelow = _mm_set1_epi8('0' - 1), nineAbove = _mm_set1_epi8('9' + 1);
+    const __m128i aBelow = _mm_set1_epi8('a' - 1), fAbove = _mm_set1_epi8('f' + 1);
+    const __m128i zero = _mm_set1_epi8('0'), letterBias = _mm_set1_epi8('a' - 10);
+    const __m128i limit = _mm_set1_epi8((char)base);
+
+    __m128i bad = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(digits + i));
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, zeroBelow), _mm_cmplt_epi8(c, nineAbove));
+        __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(c, aBelow), _mm_cmplt_epi8(c, fAbove));
+        __m128i value = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, zero)),
+                                     _mm_and_si128(isLetter, _mm_sub_epi8(c, letterBias)));
+        __m128i valid = _mm_and_si128(_mm_or_si128(isDigit, isLetter), _mm_cmplt_epi8(value, limit));
+        bad = _mm_or_si128(bad, _mm_andnot_si128(valid, _mm_set1_epi8(-1)));
+        _mm_storeu_si128((__m128i*)(values + i), value);
+    }
+    if (_mm_movemask_epi8(bad) != 0) return false;
+    return translateDigitsScalar(digits + i, length - i, base, values + i);
+}
+#endif
+
+#ifdef DIGITTRANSLATE_AVX2
+__attribute__((target("avx2")))
+inline bool translateDigitsAVX2(const char* digits, size_t length, int base, unsigned char* values)
+{
+    const __m256i zeroBelow = _mm256_set1_epi8('0' - 1), nineAbove = _mm256_set1_epi8('9' + 1);
+    const __m256i aBelow = _mm256_set1_epi8('a' - 1), fAbove = _mm256_set1_epi8('f' + 1);
+    const __m256i zero = _mm256_set1_epi8('0'), letterBias = _mm256_set1_epi8('a' - 10);
+    const __m256i limit = _mm256_set1_epi8((char)base);
+
+    __m256i valid = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(digits + i));
+        __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, zeroBelow), _mm256_cmpgt_epi8(nineAbove, c));
+        __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(c, aBelow), _mm256_cmpgt_epi8(fAbove, c));
+        __m256i value = _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(c, zero)),
+                                        _mm256_and_si256(isLetter, _mm256_sub_epi8(c, letterBias)));
+        __m256i ok = _mm256_and_si256(_mm256_or_si256(isDigit, isLetter), _mm256_cmpgt_epi8(limit, value));
+        valid = _mm256_and_si256(valid, ok);
+        _mm256_storeu_si256((__m256i*)(values + i), value);
+    }
+    if (_mm256_movemask_epi8(valid) != -1) return false;
+    return translateDigitsSSE2(digits + i, length - i, base, values + i);
+}
+#endif
+
+inline bool translateDigits(const char* digits, size_t length, int base, unsigned char* values)
+{
+#if defined(DIGITTRANSLATE_AVX2)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) return translateDigitsAVX2(digits, length, base, values);
+#endif
+#if defined(DIGITTRANSLATE_SSE2)
+    return translateDigitsSSE2(digits, length, base, values);
+#else
+    return translateDigitsScalar(digits, length, base, values);
+#endif
+}
+
+#endif // DIGITTRANSLATE_H
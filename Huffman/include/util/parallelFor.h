@@ -0,0 +1,63 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+/*
+ * parallelFor(tasks, threads, work): call work(task) once for every task in
+ * [0, tasks), on up to `threads` threads (the calling thread is one of them).
+ * Tasks are handed out through a shared counter, so a pool of workers drains
+ * them and uneven tasks balance themselves. The first exception thrown by any
+ * task stops the hand-out and is rethrown to the caller once all workers are
+ * joined.
+ */
+template <class Work>
+void parallelFor(int tasks, int threads, Work work)
+{
+    if (threads > tasks) threads = tasks;
+    if (threads <= 1) {
+        for (int task = 0; task < tasks; ++task) work(task);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::mutex failureLock;
+
+    auto worker = [&]() {
+        for (;;) {
+            int task = next.fetch_add(1);
+            if (task >= tasks) return;
+            try {
+                work(task);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(failureLock);
+                if (!failure) failure = std::current_exception();
+                next.store(tasks);
+                return;
+            }
+        }
+    };
+
+    std::thread* pool = new std::thread[threads - 1];
+    for (int i = 0; i < threads - 1; ++i) pool[i] = std::thread(worker);
+    worker();
+    for (int i = 0; i < threads - 1; ++i) pool[i].join();
+    delete[] pool;
+
+    if (failure) std::rethrow_exception(failure);
+}
+
+/*
+ * hardwareThreads(): std::thread::hardware_concurrency(), or 1 when unknown.
+ */
+inline int hardwareThreads()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores == 0 ? 1 : (int)cores;
+}
+
+#endif /* PARALLELFOR_H */
@@ -0,0 +1,143 @@
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/*
+ * NodeAllocator: where a container takes its small fixed-layout objects from
+ * (DLinkedList nodes, xMap entries) instead of new / delete.
+ *  + allocate(bytes): a block of at least bytes, aligned to `alignment`
+ *  + release(block, bytes): give one block back; bytes is what was asked for
+ *  + releaseAll(): take back every block handed out so far at once. Only a
+ *      container that is the allocator's sole user may call it (see
+ *      xMap::setAllocator); no destructors are run
+ */
+class NodeAllocator {
+public:
+    static const size_t alignment = alignof(void *);
+
+    virtual ~NodeAllocator() {}
+    virtual void *allocate(size_t bytes) = 0;
+    virtual void release(void *block, size_t bytes) = 0;
+    virtual void releaseAll() = 0;
+};
+
+/*
+ * PoolAllocator: a slab allocator for many small blocks.
+ *
+ * Blocks are cut one after the other from slabs of slabBytes, so objects
+ * allocated together (an entry and the list node that holds it) end up next
+ * to each other, with no per-block header. Released blocks go on a free list
+ * per size (multiples of 8 bytes up to maxPooled) and are handed out again
+ * before the slab is cut further; larger requests get a slab of their own,
+ * freed on release. releaseAll frees the slabs: one free per slab, whatever
+ * the number of blocks. Not thread-safe.
+ */
+class PoolAllocator : public NodeAllocator {
+public:
+    static const size_t maxPooled = 256;
+
+    explicit PoolAllocator(size_t slabBytes = 1 << 20)
+        : slabBytes(slabBytes < 4 * maxPooled ? 4 * maxPooled : slabBytes)
+    {
+        slabs = nullptr;
+        cursor = limit = nullptr;
+        slabTotal = 0;
+        for (size_t i = 0; i < classes; i++) freeLists[i] = nullptr;
+    }
+    PoolAllocator(const PoolAllocator &) = delete;
+    PoolAllocator &operator=(const PoolAllocator &) = delete;
+    ~PoolAllocator() { releaseAll(); }
+
+    void *allocate(size_t bytes)
+    {
+        if (bytes > maxPooled) return (char *)newSlab(bytes) + sizeof(Slab);
+
+        size_t size = roundUp(bytes);
+        FreeBlock *&freeList = freeLists[size / alignment - 1];
+        if (freeList != nullptr) {
+            void *block = freeList;
+            freeList = freeList->next;
+            return block;
+        }
+        if ((size_t)(limit - cursor) < size) {
+            cursor = (char *)newSlab(slabBytes - sizeof(Slab)) + sizeof(Slab);
+            limit = cursor + (slabBytes - sizeof(Slab));
+        }
+        void *block = cursor;
+        cursor += size;
+        return block;
+    }
+
+    void release(void *block, size_t bytes)
+    {
+        if (bytes > maxPooled) {
+            Slab *slab = (Slab *)((char *)block - sizeof(Slab));
+            (slab->prev != nullptr ? slab->prev->next : slabs) = slab->next;
+            if (slab->next != nullptr) slab->next->prev = slab->prev;
+            slabTotal -= slab->bytes;
+            free(slab);
+            return;
+        }
+        FreeBlock *&freeList = freeLists[roundUp(bytes) / alignment - 1];
+        FreeBlock *freeBlock = (FreeBlock *)block;
+        freeBlock->next = freeList;
+        freeList = freeBlock;
+    }
+
+    void releaseAll()
+    {
+        while (slabs != nullptr) {
+            Slab *next = slabs->next;
+            free(slabs);
+            slabs = next;
+        }
+        cursor = limit = nullptr;
+        slabTotal = 0;
+        for (size_t i = 0; i < classes; i++) freeLists[i] = nullptr;
+    }
+
+    // bytes held in slabs (what the pool costs, used or not)
+    size_t reserved() const { return slabTotal; }
+
+private:
+    struct Slab {
+        Slab *prev;
+        Slab *next;
+        size_t bytes;
+    };
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+    static const size_t classes = maxPooled / alignment;
+
+    size_t slabBytes;
+    Slab *slabs;
+    char *cursor;
+    char *limit;
+    size_t slabTotal;
+    FreeBlock *freeLists[classes];
+
+    static size_t roundUp(size_t bytes)
+    {
+        if (bytes == 0) bytes = 1;
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+    // a slab with room for bytes after its header, linked in front of slabs
+    void *newSlab(size_t bytes)
+    {
+        Slab *slab = (Slab *)malloc(sizeof(Slab) + bytes);
+        if (slab == nullptr) throw std::bad_alloc();
+        slab->prev = nullptr;
+        slab->next = slabs;
+        slab->bytes = sizeof(Slab) + bytes;
+        if (slabs != nullptr) slabs->prev = slab;
+        slabs = slab;
+        slabTotal += slab->bytes;
+        return slab;
+    }
+};
+
+#endif // POOLALLOCATOR_H
@@ -1,7 +1,7 @@
 @echo off
 setlocal enabledelayedexpansion
 
-set BUILD_CMD=g++ -std=c++17 -g -o main -Iinclude -Itest -Itest\unit_test_Huffman main.cpp ^
+set BUILD_CMD=g++ -std=c++17 -pthread -g -o main -Iinclude -Itest -Itest\unit_test_Huffman main.cpp ^
 test\unit_test_Huffman\unit_test_Huffman.cpp test\unit_test.cpp ^
 src\Point.cpp src\sampleFunc.cpp src/inventory.cpp
 
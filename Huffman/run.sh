@@ -1,6 +1,6 @@
 #!/bin/bash
 
-BUILD_CMD="g++ -fsanitize=address -g -std=c++17 -o main -Iinclude -Itest -Itest/unit_test_Huffman -g main.cpp \
+BUILD_CMD="g++ -fsanitize=address -g -std=c++17 -pthread -o main -Iinclude -Itest -Itest/unit_test_Huffman -g main.cpp \
 test/unit_test_Huffman/unit_test_Huffman.cpp test/unit_test.cpp \
  src/Point.cpp src/sampleFunc.cpp  src/inventory.cpp  test/unit_test_Huffman/test_case/*.cpp"
 
@@ -67,6 +67,30 @@ int InventoryManager::getProductQuantity(int index) const
     return quantities.get(index);
 }
 
+int InventoryManager::getAttributeCount(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+    return attributesMatrix.columns(index);
+}
+
+const InventoryAttribute &InventoryManager::getAttribute(int index, int attrIndex) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+    return attributesMatrix.at(index, attrIndex);
+}
+
+const string &InventoryManager::getProductNameRef(int index) const
+{
+    if (index < 0 || index >= size()) {
+        throw out_of_range("Index is invalid!");
+    }
+    return productNames.at(index);
+}
+
 void InventoryManager::updateQuantity(int index, int newQuantity)
 {
     // TODO
@@ -91,21 +115,10 @@ void InventoryManager::removeProduct(int index)
         throw out_of_range("Index is invalid!");
     }
 
-    List2D<InventoryAttribute> newAttributesMatrix;
-    List1D<string> newProductNames;
-    List1D<int> newQuantities;
-
-    for (int i = 0; i < size(); i++) {
-        if (i != index) {
-            newAttributesMatrix.setRow(newAttributesMatrix.rows(), attributesMatrix.getRow(i));
-            newProductNames.add(productNames.get(i));
-            newQuantities.add(quantities.get(i));
-        }
-    }
-
-    attributesMatrix = newAttributesMatrix;
-    productNames = newProductNames;
-    quantities = newQuantities;
+    //! in place: no copy of the other rows
+    attributesMatrix.removeAt(index);
+    productNames.removeAt(index);
+    quantities.removeAt(index);
 }
 
 List1D<string> InventoryManager::query(string attributeName, const double &minValue,
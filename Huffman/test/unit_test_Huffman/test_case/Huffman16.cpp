@@ -0,0 +1,58 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman16()
+{
+    string name = "Huffman16";
+    //! data ------------------------------------
+    InventoryManager manager;
+    stringstream output;
+
+    List1D<InventoryAttribute> fanAttrs;
+    fanAttrs.add(InventoryAttribute("rpm", 1230.5));
+    fanAttrs.add(InventoryAttribute("power", 45.75));
+    manager.addProduct(fanAttrs, "Fan", 5);
+
+    List1D<InventoryAttribute> lampAttrs;
+    lampAttrs.add(InventoryAttribute("power", 9.5));
+    manager.addProduct(lampAttrs, "Lamp", 2);
+
+    InvCompressorThree compressor(&manager);
+    compressor.buildHuffman();
+
+    //! output ----------------------------------
+    unsigned char buffer[64];
+    string text = compressor.productToString(fanAttrs, "Fan");
+    string digits = compressor.encodeHuffman(fanAttrs, "Fan");
+    int bits = compressor.encodeHuffman(fanAttrs, "Fan", buffer, sizeof(buffer));
+    output << "text bytes: " << text.length() << endl;
+    output << "digit bytes: " << digits.length() << endl;
+    output << "packed bits: " << bits << " (" << (bits + 7) / 8 << " bytes)" << endl;
+
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+    output << "decodeHuffman: " << compressor.decodeHuffman(buffer, bits, attributesOutput, nameOutput) << endl;
+    output << nameOutput << " " << attributesOutput.toString() << endl;
+
+    // truncated bit count is not a whole number of digits
+    output << "decodeHuffman: " << compressor.decodeHuffman(buffer, bits - 1, attributesOutput, nameOutput) << endl;
+
+    try {
+        compressor.encodeHuffman(lampAttrs, "Lamp", buffer, 2);
+    } catch (const std::exception &e) {
+        output << "Encoding Lamp failed: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "text bytes: 42\n\
+digit bytes: 112\n\
+packed bits: 224 (28 bytes)\n\
+decodeHuffman: Fan:(rpm: 1230.500000), (power: 45.750000)\n\
+Fan [rpm: 1230.500000, power: 45.750000]\n\
+decodeHuffman: \\x00\n\
+Encoding Lamp failed: Buffer is too small!\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,73 @@
+#include "../unit_test_Huffman.hpp"
+
+template <int treeOrder>
+static string compareTableWithTreeWalk()
+{
+    XArrayList<pair<char, int>> symbolFreqs;
+    const string symbols = "ABCDEFGHIJKLMNOPQRST";
+    for (int i = 0; i < (int)symbols.size(); ++i) {
+        symbolFreqs.add(make_pair(symbols[i], (i * 7) % 11 + 1));
+    }
+
+    HuffmanTree<treeOrder> tree;
+    tree.build(symbolFreqs);
+
+    // random digit strings of every length, including digits outside the tree order
+    unsigned int seed = 12345;
+    int agree = 0, total = 0;
+    for (int length = 1; length <= 40; ++length) {
+        for (int round = 0; round < 10; ++round) {
+            string code;
+            for (int i = 0; i < length; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                int digit = (seed >> 16) % (treeOrder + 1);
+                code.push_back((digit < 10) ? ('0' + digit) : ('a' + (digit - 10)));
+            }
+            if (tree.decode(code) == tree.decodeTreeWalk(code)) agree++;
+            total++;
+        }
+    }
+    stringstream ss;
+    ss << "order " << treeOrder << ": " << agree << "/" << total;
+    return ss.str();
+}
+
+bool UNIT_TEST_Huffman::Huffman17()
+{
+    string name = "Huffman17";
+    //! data ------------------------------------
+    stringstream output;
+
+    XArrayList<pair<char, int>> symbolFreqs;
+    symbolFreqs.add(make_pair('A', 5));
+    symbolFreqs.add(make_pair('B', 3));
+    symbolFreqs.add(make_pair('C', 7));
+    symbolFreqs.add(make_pair('D', 2));
+    HTree tree;
+    tree.build(symbolFreqs);
+
+    //! output ----------------------------------
+    output << tree.decode("0122110") << endl;
+    output << tree.decode("01221101") << endl;
+    output << tree.decode("10") << endl;
+    output << tree.decode("0x") << endl;
+    output << compareTableWithTreeWalk<2>() << endl;
+    output << compareTableWithTreeWalk<3>() << endl;
+    output << compareTableWithTreeWalk<5>() << endl;
+    output << compareTableWithTreeWalk<16>() << endl;
+
+    //! expect ----------------------------------
+    string expect = "ABCDA\n\
+ABCDA\n\
+\\x00\n\
+\\x00\n\
+order 2: 400/400\n\
+order 3: 400/400\n\
+order 5: 400/400\n\
+order 16: 400/400\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
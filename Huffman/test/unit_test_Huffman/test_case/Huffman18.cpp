@@ -0,0 +1,100 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman18()
+{
+    string name = "Huffman18";
+    //! data ------------------------------------
+    stringstream output;
+
+    XArrayList<pair<char, int>> symbolFreqs;
+    symbolFreqs.add(make_pair('A', 5));
+    symbolFreqs.add(make_pair('B', 3));
+    symbolFreqs.add(make_pair('C', 7));
+    symbolFreqs.add(make_pair('D', 2));
+    HTree tree;
+    tree.build(symbolFreqs);
+
+    xMap<char, string> canonicalTable(&charHashFunc);
+    tree.generateCanonicalCodes(canonicalTable);
+    output << "Canonical codes:";
+    for (char ch = 'A'; ch <= 'D'; ++ch) output << " " << ch << "=" << canonicalTable.get(ch);
+    output << endl;
+
+    XArrayList<pair<char, int>> lengths;
+    tree.codeLengths(lengths);
+    HTree rebuilt;
+    rebuilt.buildFromCodeLengths(lengths);
+    xMap<char, string> rebuiltTable(&charHashFunc);
+    rebuilt.generateCodes(rebuiltTable);
+    output << "Rebuilt codes:  ";
+    for (char ch = 'A'; ch <= 'D'; ++ch) output << " " << ch << "=" << rebuiltTable.get(ch);
+    output << endl;
+    output << "Rebuilt decode: " << rebuilt.decode("2010212") << endl;
+
+    // archive side: canonical table plus header
+    InventoryManager manager;
+    List1D<InventoryAttribute> fanAttrs;
+    fanAttrs.add(InventoryAttribute("rpm", 1230.5));
+    fanAttrs.add(InventoryAttribute("power", 45.75));
+    manager.addProduct(fanAttrs, "Fan", 5);
+
+    InvCompressor archiver(&manager);
+    archiver.buildHuffman(true);
+    string header = archiver.codebookHeader();
+    string encoded = archiver.encodeHuffman(fanAttrs, "Fan");
+    output << "Header bytes: " << header.length() << endl;
+
+    // reader side: no inventory, only the header
+    InventoryManager nothing;
+    InvCompressor reader(&nothing);
+    reader.loadCodebook(header);
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+    output << "decodeHuffman: " << reader.decodeHuffman(encoded, attributesOutput, nameOutput) << endl;
+    output << "Re-encoded equal: " << (reader.encodeHuffman(fanAttrs, "Fan") == encoded) << endl;
+
+    try {
+        InvCompressorTwo wrongOrder(&nothing);
+        wrongOrder.loadCodebook(header);
+    } catch (const std::exception &e) {
+        output << "loadCodebook failed: " << e.what() << endl;
+    }
+    try {
+        // three symbols of length 1 do not fit a binary tree
+        string overfull = string(1, (char)2) + string(1, (char)0) + string(1, (char)3) + "a\1b\1c\1";
+        InvCompressorTwo binary(&nothing);
+        binary.loadCodebook(overfull);
+    } catch (const std::exception &e) {
+        output << "loadCodebook failed: " << e.what() << endl;
+    }
+
+    // rejected headers leave the loaded codebook working: a symbol named twice, an overfull tree
+    string duplicate = string(1, (char)4) + string(1, (char)0) + string(1, (char)2) + "a\1a\1";
+    string overfullFour = string(1, (char)4) + string(1, (char)0) + string(1, (char)5) + "a\1b\1c\1d\1e\1";
+    int rejected = 0;
+    for (const string &bad : {duplicate, overfullFour}) {
+        try {
+            reader.loadCodebook(bad);
+        } catch (const std::runtime_error &) {
+            rejected++;
+        }
+    }
+    output << "rejected " << rejected << ", still decodes: " << reader.decodeHuffman(encoded, attributesOutput, nameOutput)
+           << ", re-encoded equal: " << (reader.encodeHuffman(fanAttrs, "Fan") == encoded) << endl;
+
+    //! expect ----------------------------------
+    string expect = "Canonical codes: A=0 B=20 C=1 D=21\n\
+Rebuilt codes:   A=0 B=20 C=1 D=21\n\
+Rebuilt decode: BCAD\n\
+Header bytes: 47\n\
+decodeHuffman: Fan:(rpm: 1230.500000), (power: 45.750000)\n\
+Re-encoded equal: 1\n\
+loadCodebook failed: Invalid codebook header\n\
+loadCodebook failed: Invalid codebook header\n\
+rejected 2, still decodes: Fan:(rpm: 1230.500000), (power: 45.750000), re-encoded equal: 1\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
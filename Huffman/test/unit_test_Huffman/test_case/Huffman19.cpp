@@ -0,0 +1,78 @@
+#include "../unit_test_Huffman.hpp"
+
+template <int treeOrder>
+static string compareTwoQueueWithHeap()
+{
+    unsigned int seed = 777;
+    int identical = 0, total = 0;
+    for (int symbols = 1; symbols <= 60; ++symbols) {
+        XArrayList<pair<char, int>> symbolFreqs;
+        for (int i = 0; i < symbols; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            // small range so that equal frequencies (and zeros) are common
+            symbolFreqs.add(make_pair((char)('!' + i), (int)((seed >> 16) % 6)));
+        }
+
+        HuffmanTree<treeOrder> heapTree, queueTree;
+        heapTree.build(symbolFreqs);
+        queueTree.buildTwoQueue(symbolFreqs);
+
+        xMap<char, string> heapCodes(&charHashFunc), queueCodes(&charHashFunc);
+        heapTree.generateCodes(heapCodes);
+        queueTree.generateCodes(queueCodes);
+
+        bool same = heapCodes.size() == queueCodes.size();
+        for (int i = 0; same && i < symbols; ++i) {
+            char ch = (char)('!' + i);
+            same = heapCodes.containsKey(ch) == queueCodes.containsKey(ch) &&
+                   (!heapCodes.containsKey(ch) || heapCodes.get(ch) == queueCodes.get(ch));
+        }
+        if (same) identical++;
+        total++;
+    }
+    stringstream ss;
+    ss << "order " << treeOrder << ": " << identical << "/" << total << " identical";
+    return ss.str();
+}
+
+bool UNIT_TEST_Huffman::Huffman19()
+{
+    string name = "Huffman19";
+    //! data ------------------------------------
+    stringstream output;
+
+    XArrayList<pair<char, int>> symbolFreqs;
+    symbolFreqs.add(make_pair('A', 5));
+    symbolFreqs.add(make_pair('B', 3));
+    symbolFreqs.add(make_pair('C', 7));
+    symbolFreqs.add(make_pair('D', 2));
+    HTree tree;
+    tree.buildTwoQueue(symbolFreqs);
+
+    xMap<char, string> codeTable(&charHashFunc);
+    tree.generateCodes(codeTable);
+
+    //! output ----------------------------------
+    for (char ch = 'A'; ch <= 'D'; ++ch) {
+        output << "Code for " << ch << ": " << codeTable.get(ch) << endl;
+    }
+    output << compareTwoQueueWithHeap<2>() << endl;
+    output << compareTwoQueueWithHeap<3>() << endl;
+    output << compareTwoQueueWithHeap<7>() << endl;
+    output << compareTwoQueueWithHeap<16>() << endl;
+
+    //! expect ----------------------------------
+    string expect = "Code for A: 0\n\
+Code for B: 12\n\
+Code for C: 2\n\
+Code for D: 11\n\
+order 2: 60/60 identical\n\
+order 3: 60/60 identical\n\
+order 7: 60/60 identical\n\
+order 16: 60/60 identical\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
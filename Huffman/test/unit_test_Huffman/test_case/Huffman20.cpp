@@ -0,0 +1,78 @@
+#include "../unit_test_Huffman.hpp"
+
+template <int treeOrder>
+static string lengthLimitReport(XArrayList<pair<char, int>> &symbolFreqs, int limit)
+{
+    HuffmanTree<treeOrder> tree;
+    if (limit > 0) tree.buildLengthLimited(symbolFreqs, limit);
+    else tree.build(symbolFreqs);
+
+    XArrayList<pair<char, int>> lengths;
+    tree.codeLengths(lengths);
+    xMap<char, string> codeTable(&charHashFunc);
+    tree.generateCodes(codeTable);
+
+    long long cost = 0;
+    int longest = 0;
+    string text, code;
+    for (int i = 0; i < symbolFreqs.size(); ++i) {
+        char ch = symbolFreqs.get(i).first;
+        string symbolCode = codeTable.get(ch);
+        cost += (long long)symbolFreqs.get(i).second * symbolCode.length();
+        if ((int)symbolCode.length() > longest) longest = symbolCode.length();
+        text.push_back(ch);
+        code += symbolCode;
+    }
+    stringstream ss;
+    ss << "order " << treeOrder << " limit " << limit << ": longest " << longest
+       << ", cost " << cost << ", round trip " << (tree.decode(code) == text);
+    return ss.str();
+}
+
+bool UNIT_TEST_Huffman::Huffman20()
+{
+    string name = "Huffman20";
+    //! data ------------------------------------
+    stringstream output;
+
+    // Fibonacci weights give the deepest possible Huffman tree
+    XArrayList<pair<char, int>> symbolFreqs;
+    int a = 1, b = 1;
+    for (int i = 0; i < 20; ++i) {
+        symbolFreqs.add(make_pair((char)('A' + i), a));
+        int next = a + b;
+        a = b;
+        b = next;
+    }
+
+    //! output ----------------------------------
+    output << lengthLimitReport<2>(symbolFreqs, 0) << endl;
+    output << lengthLimitReport<2>(symbolFreqs, 30) << endl;
+    output << lengthLimitReport<2>(symbolFreqs, 8) << endl;
+    output << lengthLimitReport<2>(symbolFreqs, 5) << endl;
+    output << lengthLimitReport<3>(symbolFreqs, 0) << endl;
+    output << lengthLimitReport<3>(symbolFreqs, 4) << endl;
+    output << lengthLimitReport<16>(symbolFreqs, 2) << endl;
+
+    try {
+        HTreeTow tree;
+        tree.buildLengthLimited(symbolFreqs, 4);
+    } catch (const std::exception &e) {
+        output << "limit 4: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "order 2 limit 0: longest 19, cost 46344, round trip 1\n\
+order 2 limit 30: longest 19, cost 46344, round trip 1\n\
+order 2 limit 8: longest 8, cost 46504, round trip 1\n\
+order 2 limit 5: longest 5, cost 55712, round trip 1\n\
+order 3 limit 0: longest 10, cost 28645, round trip 1\n\
+order 3 limit 4: longest 4, cost 31237, round trip 1\n\
+order 16 limit 2: longest 2, cost 17722, round trip 1\n\
+limit 4: Code length limit is too small\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,88 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman21()
+{
+    string name = "Huffman21";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager inventory;
+    List1D<InventoryAttribute> attrs1;
+    attrs1.add(InventoryAttribute("power", 1.5));
+    attrs1.add(InventoryAttribute("noise", -0.000001));
+    inventory.addProduct(attrs1, "Fan", 4);
+    List1D<InventoryAttribute> attrs2;
+    attrs2.add(InventoryAttribute("weight", 1234567.8912345));
+    inventory.addProduct(attrs2, "Laptop_\xe9", 2);
+    List1D<InventoryAttribute> attrs3;
+    inventory.addProduct(attrs3, "Empty", 1);
+
+    InvCompressor compressor(&inventory);
+    string text;
+    for (int i = 0; i < inventory.size(); ++i) {
+        text += compressor.productToString(inventory.getProductAttributes(i), inventory.getProductName(i));
+    }
+
+    CharHistogram<1> single;
+    CharHistogram<4> striped;
+    CharHistogram<8> wide;
+    compressor.countFrequencies(single);
+    compressor.countFrequencies(striped);
+    compressor.countFrequencies(wide, 0, 1);
+    CharHistogram<8> tail;
+    compressor.countFrequencies(tail, 1);
+    wide.merge(tail);
+
+    //! output ----------------------------------
+    output << compressor.productToString(inventory.getProductAttributes(0), inventory.getProductName(0)) << endl;
+    output << compressor.productToString(inventory.getProductAttributes(1), "Laptop") << endl;
+
+    int mismatches = 0;
+    for (int c = -128; c < 128; ++c) {
+        unsigned long long expected = 0;
+        for (char ch : text)
+            if (ch == (char)c) expected++;
+        if (single.count((char)c) != expected || striped.count((char)c) != expected || wide.count((char)c) != expected)
+            mismatches++;
+    }
+    output << "symbols: " << striped.symbols() << ", mismatches: " << mismatches << endl;
+
+    XArrayList<pair<char, int>> freqList;
+    striped.toFreqList(freqList);
+    output << "first: " << (int)freqList.get(0).first << " x" << freqList.get(0).second
+           << ", last: '" << freqList.get(freqList.size() - 1).first << "' x" << freqList.get(freqList.size() - 1).second << endl;
+
+    // the streamed formatter must agree with std::fixed/setprecision(6), ties included
+    int formatMismatches = 0;
+    unsigned int seed = 21;
+    List1D<InventoryAttribute> probe;
+    probe.add(InventoryAttribute("v", 0.0));
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        double value;
+        switch (i % 4) {
+        case 0: value = ((seed >> 8) % 2000001) / 2e6 - 0.5; break;          // exact .5e-6 ties
+        case 1: value = (seed >> 4) * 0.001 + 0.0000005; break;
+        case 2: value = ((seed >> 8) % 100000) / 100.0; break;
+        default: value = ldexp((double)(seed | 1), (int)(seed % 61) - 40); break;
+        }
+        probe.set(0, InventoryAttribute("v", (i & 1) ? -value : value));
+        ostringstream reference;
+        reference << "x:(v: " << fixed << setprecision(6) << probe.get(0).value << ")";
+        if (compressor.productToString(probe, "x") != reference.str())
+            formatMismatches++;
+    }
+    output << "format mismatches: " << formatMismatches << endl;
+
+    //! expect ----------------------------------
+    string expect = "Fan:(power: 1.500000), (noise: -0.000001)\n\
+Laptop:(weight: 1234567.891235)\n\
+symbols: 36, mismatches: 0\n\
+first: -23 x1, last: 'y' x1\n\
+format mismatches: 0\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
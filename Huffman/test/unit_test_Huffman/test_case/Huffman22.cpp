@@ -0,0 +1,115 @@
+#include "../unit_test_Huffman.hpp"
+
+// reference packing of a digit string, bitsPerDigit bits per digit, MSB first
+static string packDigits(const string &code, int digitBits)
+{
+    string bytes;
+    unsigned int acc = 0;
+    int accBits = 0;
+    for (char c : code) {
+        acc = (acc << digitBits) | (unsigned int)((c <= '9') ? (c - '0') : (c - 'a' + 10));
+        accBits += digitBits;
+        if (accBits >= 8) {
+            accBits -= 8;
+            bytes.push_back((char)(acc >> accBits));
+        }
+    }
+    if (accBits > 0) bytes.push_back((char)(acc << (8 - accBits)));
+    return bytes;
+}
+
+template <int treeOrder>
+static string checkFlatEncoder(InventoryManager &manager)
+{
+    InventoryCompressor<treeOrder> compressor(&manager);
+    compressor.buildHuffman();
+
+    int matches = 0, roundTrips = 0;
+    for (int i = 0; i < manager.size(); ++i) {
+        List1D<InventoryAttribute> attrs = manager.getProductAttributes(i);
+        string productName = manager.getProductName(i);
+        string code = compressor.encodeHuffman(attrs, productName);
+
+        unsigned char buffer[512];
+        int bits = compressor.encodeHuffman(attrs, productName, buffer, sizeof(buffer));
+        string packed((const char *)buffer, (bits + 7) / 8);
+        if (bits == (int)code.length() * HuffmanTree<treeOrder>::bitsPerDigit &&
+            packed == packDigits(code, HuffmanTree<treeOrder>::bitsPerDigit))
+            matches++;
+
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        if (compressor.decodeHuffman(buffer, bits, attributesOutput, nameOutput) ==
+            compressor.productToString(attrs, productName))
+            roundTrips++;
+    }
+    stringstream ss;
+    ss << "order " << treeOrder << ": packed " << matches << "/" << manager.size()
+       << ", round trip " << roundTrips << "/" << manager.size();
+    return ss.str();
+}
+
+bool UNIT_TEST_Huffman::Huffman22()
+{
+    string name = "Huffman22";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    const char *names[] = {"Fan", "Battery_AA", "Laptop", "Fridge", "Lamp"};
+    for (int i = 0; i < 5; ++i) {
+        List1D<InventoryAttribute> attrs;
+        for (int a = 0; a <= i; ++a) {
+            attrs.add(InventoryAttribute(a % 2 ? "weight" : "power", 12.5 * (i + 1) + a * 0.25));
+        }
+        manager.addProduct(attrs, names[i], i + 1);
+    }
+
+    // a binary codebook whose two deepest codes are 70 digits long (past one 64-bit word)
+    string header;
+    header.push_back((char)2);
+    header.push_back((char)0);
+    header.push_back((char)71);
+    for (int i = 0; i < 71; ++i) {
+        header.push_back((char)('!' + i));
+        header.push_back((char)(i < 70 ? i + 1 : 70));
+    }
+    InventoryManager nothing;
+    InvCompressorTwo longCodes(&nothing);
+    longCodes.loadCodebook(header);
+    List1D<InventoryAttribute> noAttrs;
+    unsigned char buffer[64];
+    int bits = longCodes.encodeHuffman(noAttrs, "fg", buffer, sizeof(buffer));
+    string code = longCodes.encodeHuffman(noAttrs, "fg");
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+
+    //! output ----------------------------------
+    output << checkFlatEncoder<2>(manager) << endl;
+    output << checkFlatEncoder<3>(manager) << endl;
+    output << checkFlatEncoder<4>(manager) << endl;
+    output << checkFlatEncoder<12>(manager) << endl;
+    output << checkFlatEncoder<16>(manager) << endl;
+    output << "long codes: " << bits << " bits, packed "
+           << (string((const char *)buffer, (bits + 7) / 8) == packDigits(code, 1)) << ", decoded "
+           << longCodes.decodeHuffman(buffer, bits, attributesOutput, nameOutput) << endl;
+    try {
+        longCodes.encodeHuffman(noAttrs, "fg~", buffer, sizeof(buffer));
+    } catch (const std::exception &e) {
+        output << "missing symbol: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "order 2: packed 5/5, round trip 5/5\n\
+order 3: packed 5/5, round trip 5/5\n\
+order 4: packed 5/5, round trip 5/5\n\
+order 12: packed 5/5, round trip 5/5\n\
+order 16: packed 5/5, round trip 5/5\n\
+long codes: 166 bits, packed 1, decoded fg:\n\
+missing symbol: key (~) is not found\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
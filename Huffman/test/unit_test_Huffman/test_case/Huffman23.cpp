@@ -0,0 +1,70 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman23()
+{
+    string name = "Huffman23";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    const char *names[] = {"Fan", "Battery", "Laptop", "Aircon", "Fridge", "Lamp", "Fan"};
+    for (int i = 0; i < 7; ++i) {
+        List1D<InventoryAttribute> attrs;
+        for (int a = 0; a < i % 3 + 1; ++a) {
+            attrs.add(InventoryAttribute(a == 0 ? "power" : "weight", 10.5 * i + a));
+        }
+        manager.addProduct(attrs, names[i], i + 1);
+    }
+
+    InvCompressorThree compressor(&manager);
+    compressor.buildHuffman();
+    HuffmanBatch batch;
+    compressor.encodeAll(batch);
+
+    //! output ----------------------------------
+    output << "products: " << batch.size() << ", bits: " << batch.bits() << ", bytes: " << batch.data.length() << endl;
+
+    // the batch is the per-product packed codes laid end to end
+    int sameBits = 0;
+    for (int i = 0; i < manager.size(); ++i) {
+        string code = compressor.encodeHuffman(manager.getProductAttributes(i), manager.getProductName(i));
+        if (batch.bitOffsets.get(i + 1) - batch.bitOffsets.get(i) == (long long)code.length() * HuffmanTree<3>::bitsPerDigit)
+            sameBits++;
+    }
+    output << "offsets match: " << sameBits << "/" << manager.size() << endl;
+
+    List2D<InventoryAttribute> attributesOutput;
+    List1D<string> namesOutput;
+    int clean = compressor.decodeAll(batch, attributesOutput, namesOutput);
+    output << "decoded: " << clean << endl;
+    output << "names: " << namesOutput << endl;
+    output << "row 5: " << attributesOutput.getRow(5) << endl;
+
+    // a corrupted digit (binary 11 is not a base-3 digit) only spoils its own product
+    HuffmanBatch damaged = batch;
+    damaged.data[0] = (char)0xff;
+    List2D<InventoryAttribute> damagedAttributes;
+    List1D<string> damagedNames;
+    clean = compressor.decodeAll(damaged, damagedAttributes, damagedNames);
+    output << "damaged: " << clean << " clean, names " << damagedNames << endl;
+
+    InventoryManager empty;
+    InvCompressorThree emptyCompressor(&empty);
+    HuffmanBatch emptyBatch;
+    emptyCompressor.encodeAll(emptyBatch);
+    output << "empty: " << emptyBatch.size() << " products, " << emptyBatch.bits() << " bits" << endl;
+
+    //! expect ----------------------------------
+    string expect = "products: 7, bits: 1582, bytes: 198\n\
+offsets match: 7/7\n\
+decoded: 7\n\
+names: [Fan, Battery, Laptop, Aircon, Fridge, Lamp, Fan]\n\
+row 5: [power: 52.500000, weight: 53.500000, weight: 54.500000]\n\
+damaged: 6 clean, names [, Battery, Laptop, Aircon, Fridge, Lamp, Fan]\n\
+empty: 0 products, 0 bits\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
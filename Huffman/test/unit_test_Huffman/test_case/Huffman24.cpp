@@ -0,0 +1,73 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman24()
+{
+    string name = "Huffman24";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    const char *names[] = {"Fan", "Battery", "Laptop", "Aircon", "Fridge", "Lamp"};
+    unsigned int seed = 24;
+    for (int i = 0; i < 301; ++i) {
+        List1D<InventoryAttribute> attrs;
+        seed = seed * 1103515245u + 12345u;
+        int count = (seed >> 16) % 4;
+        for (int a = 0; a < count; ++a) {
+            seed = seed * 1103515245u + 12345u;
+            attrs.add(InventoryAttribute(a % 2 ? "weight" : "power", ((seed >> 12) % 100000) / 100.0));
+        }
+        manager.addProduct(attrs, string(names[i % 6]) + to_string(i % 7), 1);
+    }
+
+    InvCompressorThree serial(&manager);
+    serial.buildHuffman(true);
+    HuffmanBatch expected;
+    serial.encodeAll(expected);
+
+    //! output ----------------------------------
+    int threadCounts[] = {2, 3, 8, 64};
+    for (int threads : threadCounts) {
+        InvCompressorThree parallel(&manager);
+        parallel.setThreadCount(threads);
+        parallel.buildHuffman(true);
+        HuffmanBatch batch;
+        parallel.encodeAll(batch);
+
+        bool sameOffsets = batch.size() == expected.size();
+        for (int i = 0; sameOffsets && i <= batch.size(); ++i)
+            sameOffsets = batch.bitOffsets.get(i) == expected.bitOffsets.get(i);
+
+        List2D<InventoryAttribute> attributesOutput;
+        List1D<string> namesOutput;
+        output << threads << " threads: codebook " << (parallel.codebookHeader() == serial.codebookHeader())
+               << ", data " << (batch.data == expected.data) << ", offsets " << sameOffsets
+               << ", decoded " << parallel.decodeAll(batch, attributesOutput, namesOutput) << endl;
+    }
+
+    // a symbol the codebook has never seen, thrown on a worker thread
+    List1D<InventoryAttribute> odd;
+    odd.add(InventoryAttribute("power~", 1.0));
+    manager.addProduct(odd, "Fan0", 1);
+    try {
+        InvCompressorThree parallel(&manager);
+        parallel.setThreadCount(4);
+        parallel.loadCodebook(serial.codebookHeader());
+        HuffmanBatch batch;
+        parallel.encodeAll(batch);
+    } catch (const std::exception &e) {
+        output << "encodeAll failed: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "2 threads: codebook 1, data 1, offsets 1, decoded 301\n\
+3 threads: codebook 1, data 1, offsets 1, decoded 301\n\
+8 threads: codebook 1, data 1, offsets 1, decoded 301\n\
+64 threads: codebook 1, data 1, offsets 1, decoded 301\n\
+encodeAll failed: key (~) is not found\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,95 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman25()
+{
+    string name = "Huffman25";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    const char *names[] = {"Fan", "Battery", "Laptop", "Aircon", "Fridge", "Lamp"};
+    unsigned int seed = 25;
+    for (int i = 0; i < 50; ++i) {
+        List1D<InventoryAttribute> attrs;
+        seed = seed * 1103515245u + 12345u;
+        int count = (seed >> 16) % 4;
+        for (int a = 0; a < count; ++a) {
+            seed = seed * 1103515245u + 12345u;
+            attrs.add(InventoryAttribute(a % 2 ? "weight" : "power", ((seed >> 12) % 100000) / 100.0));
+        }
+        manager.addProduct(attrs, string(names[i % 6]) + to_string(i % 7), 1);
+    }
+
+    InvCompressor compressor(&manager);
+    compressor.buildHuffman();
+    HuffmanBatch batch;
+    compressor.encodeAll(batch);
+    List2D<InventoryAttribute> expectedRows;
+    List1D<string> expectedNames;
+    compressor.decodeAll(batch, expectedRows, expectedNames);
+
+    //! output ----------------------------------
+    int intervals[] = {1, 7, 50, 1000};
+    for (int interval : intervals) {
+        string container = compressor.encodeContainer(interval);
+        for (int threads = 1; threads <= 4; threads += 3) {
+            compressor.setThreadCount(threads);
+            List2D<InventoryAttribute> rows;
+            List1D<string> productNames;
+            int clean = compressor.decodeContainer(container, rows, productNames);
+            output << "interval " << interval << ", " << threads << " thread(s): "
+                   << container.length() << " bytes, decoded " << clean
+                   << ", same " << (rows.toString() == expectedRows.toString() && productNames.toString() == expectedNames.toString()) << endl;
+        }
+    }
+
+    // a damaged length varint only loses the rest of its own block
+    string container = compressor.encodeContainer(10);
+    size_t lengthsStart = 17 + 5 * 16;
+    string damaged = container;
+    damaged[lengthsStart + 3] = (char)0x7f;
+    List2D<InventoryAttribute> rows;
+    List1D<string> productNames;
+    output << "damaged length: decoded " << compressor.decodeContainer(damaged, rows, productNames)
+           << ", rows " << rows.rows() << ", name 2 '" << productNames.get(2) << "', name 10 '" << productNames.get(10) << "'" << endl;
+
+    string truncated = container.substr(0, 60);
+    try {
+        compressor.decodeContainer(truncated, rows, productNames);
+    } catch (const std::exception &e) {
+        output << "truncated: " << e.what() << endl;
+    }
+    // 2^31 - 1 products claimed by a 33-byte container: rejected before any allocation
+    string oversized = string("HUFB") + (char)4 + string("\x7f\xff\xff\xff\x7f\xff\xff\xff", 8) + string(20, '\0');
+    try {
+        compressor.decodeContainer(oversized, rows, productNames);
+    } catch (const std::exception &e) {
+        output << "oversized: " << e.what() << endl;
+    }
+    try {
+        InventoryManager nothing;
+        InvCompressorTwo wrongOrder(&nothing);
+        wrongOrder.decodeContainer(container, rows, productNames);
+    } catch (const std::exception &e) {
+        output << "wrong order: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "interval 1, 1 thread(s): 1967 bytes, decoded 50, same 1\n\
+interval 1, 4 thread(s): 1967 bytes, decoded 50, same 1\n\
+interval 7, 1 thread(s): 1295 bytes, decoded 50, same 1\n\
+interval 7, 4 thread(s): 1295 bytes, decoded 50, same 1\n\
+interval 50, 1 thread(s): 1183 bytes, decoded 50, same 1\n\
+interval 50, 4 thread(s): 1183 bytes, decoded 50, same 1\n\
+interval 1000, 1 thread(s): 1183 bytes, decoded 50, same 1\n\
+interval 1000, 4 thread(s): 1183 bytes, decoded 50, same 1\n\
+damaged length: decoded 48, rows 50, name 2 'Laptop2', name 10 'Fridge3'\n\
+truncated: Invalid container\n\
+oversized: Invalid container\n\
+wrong order: Invalid container\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,92 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman26()
+{
+    string name = "Huffman26";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    List1D<InventoryAttribute> fanAttrs;
+    fanAttrs.add(InventoryAttribute("power", 45.75));
+    fanAttrs.add(InventoryAttribute("noise", -0.1));
+    manager.addProduct(fanAttrs, "Fan", 5);
+    List1D<InventoryAttribute> oddAttrs;
+    oddAttrs.add(InventoryAttribute("power", 1.0 / 3));        // no short decimal form: raw bytes
+    oddAttrs.add(InventoryAttribute("weight", 1e300));
+    oddAttrs.add(InventoryAttribute("noise", 0.0000001));
+    manager.addProduct(oddAttrs, string("Odd\0\xff", 5), 1);
+    List1D<InventoryAttribute> noAttrs;
+    manager.addProduct(noAttrs, "Empty", 2);
+
+    InvCompressor compressor(&manager);
+    compressor.setSerializationMode(BINARY_SERIALIZATION);
+    compressor.buildHuffman(true);
+
+    //! output ----------------------------------
+    string record = compressor.serializeProduct(fanAttrs, "Fan");
+    string text = compressor.productToString(fanAttrs, "Fan");
+    output << "Fan record: " << record.length() << " bytes (text " << text.length() << "):";
+    for (unsigned char byte : record) output << " " << (int)byte;
+    output << endl;
+
+    int exact = 0;
+    for (int i = 0; i < manager.size(); ++i) {
+        List1D<InventoryAttribute> attrs = manager.getProductAttributes(i);
+        string productName = manager.getProductName(i);
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        string decoded = compressor.decodeHuffman(compressor.encodeHuffman(attrs, productName), attributesOutput, nameOutput);
+        if (decoded == compressor.productToString(attrs, productName) && nameOutput == productName &&
+            attributesOutput.toString() == attrs.toString()) {
+            bool bitExact = true;
+            for (int a = 0; a < attrs.size(); ++a)
+                bitExact = bitExact && attributesOutput.get(a) == attrs.get(a);
+            if (bitExact) exact++;
+        }
+    }
+    output << "exact round trips: " << exact << "/" << manager.size() << endl;
+
+    // reader side: codebook + attribute dictionary only
+    InventoryManager nothing;
+    InvCompressor reader(&nothing);
+    reader.setSerializationMode(BINARY_SERIALIZATION);
+    reader.loadCodebook(compressor.codebookHeader());
+    reader.loadAttributeDictionary(compressor.attributeDictionary());
+    string container = compressor.encodeContainer(2);
+    List2D<InventoryAttribute> rows;
+    List1D<string> productNames;
+    output << "dictionary: " << compressor.attributeDictionary().length() << " bytes" << endl;
+    output << "container decoded: " << reader.decodeContainer(container, rows, productNames)
+           << ", row 0: " << rows.getRow(0) << ", name 2: " << productNames.get(2) << endl;
+
+    try {
+        List1D<InventoryAttribute> unknown;
+        unknown.add(InventoryAttribute("voltage", 220));
+        compressor.encodeHuffman(unknown, "Fan");
+    } catch (const std::exception &e) {
+        output << "encode failed: " << e.what() << endl;
+    }
+    try {
+        reader.loadAttributeDictionary(string("\x05\x03pow", 5));
+    } catch (const std::exception &e) {
+        output << "load failed: " << e.what() << endl;
+    }
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+    output << "garbage: " << compressor.decodeHuffman(compressor.encodeHuffman(noAttrs, "Fan").substr(0, 6), attributesOutput, nameOutput) << endl;
+
+    //! expect ----------------------------------
+    string expect = "Fan record: 11 bytes (text 42): 3 70 97 110 2 0 242 187 4 1 9\n\
+exact round trips: 3/3\n\
+dictionary: 20 bytes\n\
+container decoded: 3, row 0: [power: 45.750000, noise: -0.100000], name 2: Empty\n\
+encode failed: attribute (voltage) is not found\n\
+load failed: Invalid attribute dictionary\n\
+garbage: \\x00\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,126 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman27()
+{
+    string name = "Huffman27";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    for (int i = 0; i < 40; ++i) {
+        List1D<InventoryAttribute> attrs;
+        attrs.add(InventoryAttribute("power", 100 + (i % 7) * 2.5));
+        if (i % 3 == 0) attrs.add(InventoryAttribute("noise", -0.25 * (i % 5)));
+        attrs.add(InventoryAttribute("weight", 1.0 + i / 10));
+        manager.addProduct(attrs, i % 2 ? "Fan" : "Lamp", i * 3 - 20);
+    }
+    List1D<InventoryAttribute> oddAttrs;
+    oddAttrs.add(InventoryAttribute("power", 1.0 / 3));
+    oddAttrs.add(InventoryAttribute("weight", 1e-9));
+    manager.addProduct(oddAttrs, string("Odd\0\xff", 5), -7);
+    List1D<InventoryAttribute> noAttrs;
+    manager.addProduct(noAttrs, "", 0);
+
+    ColumnarCompressor<4> columnar(&manager);
+    InvCompressor rows(&manager);
+    rows.setSerializationMode(BINARY_SERIALIZATION);
+    rows.buildHuffman(true);
+
+    //! output ----------------------------------
+    string archive = columnar.compress();
+    size_t rowWise = rows.encodeContainer().length() + rows.codebookHeader().length() + rows.attributeDictionary().length();
+    output << "columnar smaller than row-wise: " << (archive.length() < rowWise) << endl;
+
+    InventoryManager restored = columnar.decompress(archive);
+    output << "products: " << restored.size() << endl;
+    output << "same inventory: " << (restored.toString() == manager.toString()) << endl;
+    int exact = 0;
+    for (int i = 0; i < manager.size(); ++i) {
+        bool same = restored.getProductName(i) == manager.getProductName(i) &&
+                    restored.getProductQuantity(i) == manager.getProductQuantity(i) &&
+                    restored.getAttributeCount(i) == manager.getAttributeCount(i);
+        for (int a = 0; same && a < manager.getAttributeCount(i); ++a)
+            same = restored.getAttribute(i, a) == manager.getAttribute(i, a);
+        if (same) exact++;
+    }
+    output << "exact products: " << exact << "/" << manager.size() << endl;
+    output << "row 41: " << restored.getProductAttributes(40) << endl;
+
+    InventoryManager empty;
+    ColumnarCompressor<2> emptyColumnar(&empty);
+    string emptyArchive = emptyColumnar.compress();
+    output << "empty archive: " << emptyArchive.length() << " bytes, " << emptyColumnar.decompress(emptyArchive).size() << " products" << endl;
+
+    // columns of one distinct byte: every quantity 7, every weight 1, no names
+    InventoryManager uniform;
+    for (int i = 0; i < 5; ++i) {
+        List1D<InventoryAttribute> attrs;
+        attrs.add(InventoryAttribute("weight", 1.0));
+        uniform.addProduct(attrs, "", 7);
+    }
+    ColumnarCompressor<4> uniformColumnar(&uniform);
+    string uniformArchive = uniformColumnar.compress();
+    output << "uniform columns: " << (uniformColumnar.decompress(uniformArchive).toString() == uniform.toString()) << endl;
+    List1D<string> weight;
+    weight.add("weight");
+    InventoryManager weights = uniformColumnar.decompress(uniformArchive, weight, false, true);
+    output << "uniform projection: " << weights.size() << " products, " << weights.getProductQuantity(4) << " x "
+           << weights.getProductAttributes(4) << endl;
+    InventoryManager single;
+    single.addProduct(noAttrs, "Solo", 3);
+    ColumnarCompressor<3> singleColumnar(&single);
+    output << "one product: " << (singleColumnar.decompress(singleColumnar.compress()).toString() == single.toString()) << endl;
+
+    // hostile headers: 2^31 - 1 products and no columns; a column claiming 2^60 bytes
+    auto bytes = [](std::initializer_list<int> list) {
+        string out;
+        for (int b : list) out.push_back((char)b);
+        return out;
+    };
+    string noColumns = bytes({'H', 'U', 'F', 'C', 4, 0xff, 0xff, 0xff, 0xff, 0x07, 0, 0});
+    string hugeColumn = bytes({'H', 'U', 'F', 'C', 4, 1, 0, 3, 0, 16, 1, 5, 2, 5,
+                               0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x10, 2, 'a', 1, 'b', 1, 8, 0x55,
+                               1, 1, 2, 0, 0,
+                               1, 1, 0, 0, 0});
+    try {
+        columnar.decompress(noColumns, List1D<string>());
+    } catch (const std::exception &e) {
+        output << "no columns: " << e.what() << endl;
+    }
+    try {
+        columnar.decompress(hugeColumn);
+    } catch (const std::exception &e) {
+        output << "huge column: " << e.what() << endl;
+    }
+
+    try {
+        columnar.decompress(archive.substr(0, archive.length() - 1));
+    } catch (const std::exception &e) {
+        output << "truncated: " << e.what() << endl;
+    }
+    try {
+        emptyColumnar.decompress(archive);
+    } catch (const std::exception &e) {
+        output << "wrong order: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "columnar smaller than row-wise: 1\n\
+products: 42\n\
+same inventory: 1\n\
+exact products: 42/42\n\
+row 41: [power: 0.333333, weight: 0.000000]\n\
+empty archive: 17 bytes, 0 products\n\
+uniform columns: 1\n\
+uniform projection: 5 products, 7 x [weight: 1.000000]\n\
+one product: 1\n\
+no columns: Invalid columnar archive\n\
+huge column: Invalid columnar archive\n\
+truncated: Invalid columnar archive\n\
+wrong order: Invalid columnar archive\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
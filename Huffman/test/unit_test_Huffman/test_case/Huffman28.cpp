@@ -0,0 +1,62 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman28()
+{
+    string name = "Huffman28";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    List1D<InventoryAttribute> fanAttrs;
+    fanAttrs.add(InventoryAttribute("power", 45.5));
+    fanAttrs.add(InventoryAttribute("noise", 20));
+    manager.addProduct(fanAttrs, "Fan", 5);
+    List1D<InventoryAttribute> lampAttrs;
+    lampAttrs.add(InventoryAttribute("weight", 0.75));
+    lampAttrs.add(InventoryAttribute("power", 9));
+    manager.addProduct(lampAttrs, "Lamp", 12);
+    List1D<InventoryAttribute> boxAttrs;
+    boxAttrs.add(InventoryAttribute("weight", 3));
+    manager.addProduct(boxAttrs, "Box", -1);
+
+    ColumnarCompressor<3> columnar(&manager);
+    string archive = columnar.compress();
+
+    //! output ----------------------------------
+    List1D<string> power;
+    power.add("power");
+    InventoryManager powerOnly = columnar.decompress(archive, power);
+    output << "power: " << powerOnly.getAttributesMatrix() << endl;
+    output << "names: " << powerOnly.getProductNames() << ", quantities: " << powerOnly.getQuantities() << endl;
+
+    List1D<string> mixed;
+    mixed.add("weight");
+    mixed.add("voltage");
+    mixed.add("noise");
+    InventoryManager withNames = columnar.decompress(archive, mixed, true, true);
+    output << "weight+noise: " << withNames.getAttributesMatrix() << endl;
+    output << "names: " << withNames.getProductNames() << ", quantities: " << withNames.getQuantities() << endl;
+
+    List1D<string> none;
+    InventoryManager quantitiesOnly = columnar.decompress(archive, none, false, true);
+    output << "quantities only: " << quantitiesOnly.getQuantities() << ", rows: " << quantitiesOnly.getAttributesMatrix() << endl;
+
+    try {
+        columnar.decompress(archive.substr(0, 20), power);
+    } catch (const std::exception &e) {
+        output << "truncated: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "power: [[power: 45.500000], [power: 9.000000], []]\n\
+names: [, , ], quantities: [0, 0, 0]\n\
+weight+noise: [[noise: 20.000000], [weight: 0.750000], [weight: 3.000000]]\n\
+names: [Fan, Lamp, Box], quantities: [5, 12, -1]\n\
+quantities only: [5, 12, -1], rows: [[], [], []]\n\
+truncated: Invalid columnar archive\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,72 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman29()
+{
+    string name = "Huffman29";
+    //! data ------------------------------------
+    stringstream output;
+
+    // writer and reader share nothing but the coded products
+    InventoryManager feed;
+    InventoryManager nothing;
+    InvCompressor writer(&feed);
+    InvCompressor reader(&nothing);
+
+    AdaptiveHuffmanTree<4> model;
+    string digits;
+    model.encode('A', digits);
+    model.encode('A', digits);
+    model.encode('B', digits);
+    model.encode('A', digits);
+
+    //! output ----------------------------------
+    output << "AABA: " << digits << ", symbols: " << model.symbols() << endl;
+
+    int clean = 0;
+    string firstCode, lastCode;
+    for (int i = 0; i < 30; ++i) {
+        List1D<InventoryAttribute> attrs;
+        attrs.add(InventoryAttribute("power", 10 + i % 4));
+        attrs.add(InventoryAttribute("noise", 0.5));
+        string productName = (i % 2) ? "Fan" : "Lamp";
+        feed.addProduct(attrs, productName, i);
+
+        string code = writer.encodeAdaptive(attrs, productName);
+        if (i == 0) firstCode = code;
+        lastCode = code;
+        List1D<InventoryAttribute> attributesOutput;
+        string nameOutput;
+        string decoded = reader.decodeAdaptive(code, attributesOutput, nameOutput);
+        if (decoded == writer.productToString(attrs, productName) && nameOutput == productName &&
+            attributesOutput.toString() == attrs.toString())
+            clean++;
+    }
+    output << "streamed products decoded: " << clean << "/30" << endl;
+    output << "first / last code digits: " << firstCode.length() << " / " << lastCode.length() << endl;
+
+    // a product the reader never saw puts it out of step
+    List1D<InventoryAttribute> attrs;
+    attrs.add(InventoryAttribute("weight", 2));
+    writer.encodeAdaptive(attrs, "Box");
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+    output << "out of step: " << reader.decodeAdaptive(writer.encodeAdaptive(attrs, "Box"), attributesOutput, nameOutput) << endl;
+
+    writer.resetAdaptive();
+    reader.resetAdaptive();
+    output << "after reset: " << reader.decodeAdaptive(writer.encodeAdaptive(attrs, "Box"), attributesOutput, nameOutput) << endl;
+    output << "truncated: " << reader.decodeAdaptive(writer.encodeAdaptive(attrs, "Box").substr(0, 5), attributesOutput, nameOutput) << endl;
+
+    //! expect ----------------------------------
+    string expect = "AABA: 10010310020, symbols: 2\n\
+streamed products decoded: 30/30\n\
+first / last code digits: 167 / 80\n\
+out of step: \\x00\n\
+after reset: Box:(weight: 2.000000)\n\
+truncated: \\x00\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
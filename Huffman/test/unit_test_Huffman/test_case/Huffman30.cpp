@@ -0,0 +1,72 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman30()
+{
+    string name = "Huffman30";
+    //! data ------------------------------------
+    stringstream output;
+
+    InventoryManager manager;
+    for (int i = 0; i < 20; ++i) {
+        List1D<InventoryAttribute> attrs;
+        attrs.add(InventoryAttribute("power", 10 + i % 5));
+        manager.addProduct(attrs, "Fan", i);
+    }
+    InvCompressor compressor(&manager);
+    compressor.buildHuffman(true);
+
+    //! output ----------------------------------
+    output << "built: version " << compressor.codebookVersion() << endl;
+
+    List1D<InventoryAttribute> sameAttrs;
+    sameAttrs.add(InventoryAttribute("power", 12));
+    compressor.addProduct(sameAttrs, "Fan", 3);
+    compressor.updateQuantity(0, 99);
+    output << "similar product: version " << compressor.codebookVersion()
+           << ", size " << manager.size() << ", quantity 0: " << manager.getProductQuantity(0) << endl;
+
+    List1D<InventoryAttribute> newAttrs;
+    newAttrs.add(InventoryAttribute("weight", 7));
+    compressor.addProduct(newAttrs, "Box", 1);
+    List1D<InventoryAttribute> attributesOutput;
+    string nameOutput;
+    output << "new characters: version " << compressor.codebookVersion() << ", "
+           << compressor.decodeHuffman(compressor.encodeHuffman(newAttrs, "Box"), attributesOutput, nameOutput) << endl;
+
+    // drift: a stream of very different products
+    compressor.setRebuildThreshold(0.2);
+    int rebuilds = compressor.codebookVersion();
+    for (int i = 0; i < 200; ++i) {
+        compressor.addProduct(newAttrs, "Box", 1);
+        compressor.removeProduct(0);
+    }
+    rebuilds = compressor.codebookVersion() - rebuilds;
+    output << "drift rebuilt the code: " << (rebuilds >= 1) << ", at most a few times: " << (rebuilds <= 5)
+           << ", inefficiency within threshold: " << (compressor.estimatedInefficiency() <= 0.2) << endl;
+
+    // the live histogram matches a full recount
+    compressor.setRebuildThreshold(-1);
+    compressor.addProduct(sameAttrs, "Fan", 3);
+    InvCompressor recount(&manager);
+    recount.buildHuffman(true);
+    output << "same codebook as a full rebuild: " << (compressor.codebookHeader() == recount.codebookHeader()) << endl;
+
+    try {
+        compressor.removeProduct(1000);
+    } catch (const std::exception &e) {
+        output << "remove failed: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "built: version 1\n\
+similar product: version 1, size 21, quantity 0: 99\n\
+new characters: version 2, Box:(weight: 7.000000)\n\
+drift rebuilt the code: 1, at most a few times: 1, inefficiency within threshold: 1\n\
+same codebook as a full rebuild: 1\n\
+remove failed: Index is invalid!\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
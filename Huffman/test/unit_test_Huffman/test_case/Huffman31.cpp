@@ -0,0 +1,79 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman31()
+{
+    string name = "Huffman31";
+    //! data ------------------------------------
+    stringstream output;
+
+    // very skewed: one symbol dominates, so a binary code wins
+    XArrayList<pair<char, int>> skewed;
+    skewed.add({'a', 1000});
+    skewed.add({'b', 10});
+    skewed.add({'c', 10});
+    skewed.add({'d', 1});
+    // 256 equally likely bytes: every power-of-two order packs them into 8 bits
+    XArrayList<pair<char, int>> uniform;
+    for (int c = -128; c < 128; ++c) uniform.add({(char)c, 100});
+
+    InventoryManager manager;
+    for (int i = 0; i < 50; ++i) {
+        List1D<InventoryAttribute> attrs;
+        attrs.add(InventoryAttribute("power", 100 + i));
+        attrs.add(InventoryAttribute("noise", i % 7));
+        manager.addProduct(attrs, i % 3 ? "Fan" : "Lamp", i);
+    }
+
+    //! output ----------------------------------
+    TreeOrderEstimate estimates[maxTreeOrder - minTreeOrder + 1];
+    TreeOrderEstimate choice = chooseTreeOrder(skewed, 0, estimates);
+    output << "skewed: order " << choice.order << ", digits " << choice.digits
+           << " (order 4: " << estimates[4 - minTreeOrder].digits << ")" << endl;
+    output << "uniform, size only: order " << chooseTreeOrder(uniform, 0).order << endl;
+    output << "uniform, decode weighted: order " << chooseTreeOrder(uniform, 100).order << endl;
+
+    choice = chooseTreeOrder(&manager, TEXT_SERIALIZATION, 0, estimates);
+    bool exact = true;
+    for (int order = minTreeOrder; order <= maxTreeOrder; ++order) {
+        TreeOrderEstimate estimate = estimates[order - minTreeOrder];
+        long long packedBits = withTreeOrder(order, [&](auto treeOrder) {
+            InventoryCompressor<decltype(treeOrder)::value> compressor(&manager);
+            compressor.buildHuffman(true);
+            HuffmanBatch batch;
+            compressor.encodeAll(batch);
+            return batch.bits() + 8LL * (long long)compressor.codebookHeader().length();
+        });
+        exact = exact && packedBits == (long long)estimate.bits;
+    }
+    output << "estimates match encodeAll + codebook for every order: " << exact << endl;
+
+    int clean = withTreeOrder(choice.order, [&](auto treeOrder) {
+        InventoryCompressor<decltype(treeOrder)::value> compressor(&manager);
+        compressor.buildHuffman(true);
+        HuffmanBatch batch;
+        compressor.encodeAll(batch);
+        List2D<InventoryAttribute> rows;
+        List1D<string> names;
+        return compressor.decodeAll(batch, rows, names);
+    });
+    output << "chosen order round trip: " << clean << "/" << manager.size() << endl;
+
+    try {
+        withTreeOrder(17, [](auto treeOrder) { return decltype(treeOrder)::value; });
+    } catch (const std::exception &e) {
+        output << "order 17: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "skewed: order 2, digits 1053 (order 4: 1021)\n\
+uniform, size only: order 2\n\
+uniform, decode weighted: order 16\n\
+estimates match encodeAll + codebook for every order: 1\n\
+chosen order round trip: 50/50\n\
+order 17: treeOrder is out of range!\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,87 @@
+#include "../unit_test_Huffman.hpp"
+
+// decode / decodePacked (specialised kernels) against the generic kernels
+template <int treeOrder>
+static string compareKernels(const string &text)
+{
+    XArrayList<pair<char, int>> freqList;
+    int counts[256] = {0};
+    for (char c : text) counts[(unsigned char)c]++;
+    for (int c = 0; c < 256; ++c)
+        if (counts[c] > 0) freqList.add({(char)c, counts[c]});
+
+    HuffmanTree<treeOrder> tree;
+    tree.build(freqList);
+    xMap<char, string> table([](char &key, int size) { return (int)(unsigned char)key % size; });
+    tree.generateCodes(table);
+    string code;
+    for (char c : text) code += table.get(c);
+
+    const int bits = HuffmanTree<treeOrder>::bitsPerDigit;
+    string packed((code.size() * bits + 7) / 8, '\0');
+    for (size_t i = 0; i < code.size(); ++i) {
+        int digit = code[i] <= '9' ? code[i] - '0' : code[i] - 'a' + 10;
+        for (int b = 0; b < bits; ++b) {
+            size_t bit = i * bits + b;
+            if (digit >> (bits - 1 - b) & 1) packed[bit >> 3] |= (char)(0x80 >> (bit & 7));
+        }
+    }
+    const unsigned char *data = (const unsigned char *)packed.data();
+
+    int same = 0, total = 0;
+    auto check = [&](const string &digits) {
+        total++;
+        if (tree.decode(digits) == tree.decodeGeneric(digits)) same++;
+    };
+    check(code);
+    check(code.substr(0, code.size() / 2));
+    check(code.substr(0, code.size() / 2) + "z" + code.substr(code.size() / 2));
+    check(code.substr(0, 9) + "g" + code.substr(9));
+    check(code.substr(0, 9) + (treeOrder < 10 ? "9" : "F") + code.substr(9));
+    check("");
+
+    long long bitCount = (long long)code.size() * bits;
+    for (long long first = 0; first <= 3 * bits; first += bits) {
+        string special, generic;
+        bool specialOk = tree.decodePacked(data, first, bitCount - first, special);
+        bool genericOk = tree.decodePackedGeneric(data, first, bitCount - first, generic);
+        total++;
+        if (specialOk == genericOk && special == generic) same++;
+    }
+
+    string decoded;
+    bool ok = tree.decodePacked(data, 0, bitCount, decoded);
+    return "order " + to_string(treeOrder) + ": " + to_string(same) + "/" + to_string(total) +
+           " agree, round trip " + to_string(ok && decoded == text && tree.decode(code) == text);
+}
+
+bool UNIT_TEST_Huffman::Huffman32()
+{
+    string name = "Huffman32";
+    //! data ------------------------------------
+    stringstream output;
+    string text;
+    for (int i = 0; i < 300; ++i) text += "Lamp_" + to_string(i * 37 % 101) + (i % 3 ? ",power:" : ",noise:") + to_string(i % 7) + ";";
+
+    //! output ----------------------------------
+    output << "specialised: " << HTreeTow::powerOfTwo << HTree::powerOfTwo << HTreeFour::powerOfTwo
+           << HTreeEight::powerOfTwo << HuffmanTree<16>::powerOfTwo << endl;
+    output << compareKernels<2>(text) << endl;
+    output << compareKernels<4>(text) << endl;
+    output << compareKernels<8>(text) << endl;
+    output << compareKernels<16>(text) << endl;
+    output << compareKernels<3>(text) << endl;
+
+    //! expect ----------------------------------
+    string expect = "specialised: 10111\n\
+order 2: 10/10 agree, round trip 1\n\
+order 4: 10/10 agree, round trip 1\n\
+order 8: 10/10 agree, round trip 1\n\
+order 16: 10/10 agree, round trip 1\n\
+order 3: 10/10 agree, round trip 1\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
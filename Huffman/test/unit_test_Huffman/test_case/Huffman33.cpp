@@ -0,0 +1,89 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman33()
+{
+    string name = "Huffman33";
+    //! data ------------------------------------
+    stringstream output;
+    typedef bool (*Kernel)(const char *, size_t, int, unsigned char *);
+    Kernel kernels[3];
+    int kernelCount = 0;
+    kernels[kernelCount++] = translateDigitsScalar;
+#ifdef DIGITTRANSLATE_SSE2
+    kernels[kernelCount++] = translateDigitsSSE2;
+#endif
+    kernels[kernelCount++] = translateDigits;   // AVX2 where the CPU has it
+    const char alphabet[] = "0123456789abcdef";
+    const char strays[] = {'/', ':', '`', 'g', 'A', 'F', ' ', '\0', (char)0x80, (char)0xb0, (char)0xe1, (char)0xff};
+    unsigned int seed = 12345;
+    auto next = [&]() { seed = seed * 1103515245u + 12345u; return (int)(seed >> 16); };
+
+    //! output ----------------------------------
+    int agree = 0, cases = 0, rejected = 0, translated = 0;
+    const int bases[4] = {2, 3, 10, 16};
+    for (int b = 0; b < 4; ++b) {
+        int base = bases[b];
+        for (int length = 0; length <= 70; ++length) {
+            string digits(length, '0');
+            for (int i = 0; i < length; ++i) digits[i] = alphabet[next() % base];
+
+            // valid run, then one bad character (stray or digit == base) at each position
+            for (int bad = -1; bad < length; ++bad) {
+                string input = digits;
+                if (bad >= 0) input[bad] = (next() % 3 == 0 && base < 16) ? alphabet[base] : strays[next() % 12];
+
+                bool expectOk = true;
+                unsigned char expected[80];
+                for (int i = 0; i < length; ++i) {
+                    const char *at = strchr(alphabet, input[i]);
+                    int value = (input[i] != '\0' && at != nullptr) ? (int)(at - alphabet) : 99;
+                    if (value >= base) expectOk = false;
+                    expected[i] = (unsigned char)value;
+                }
+                for (int k = 0; k < kernelCount; ++k) {
+                    unsigned char values[80];
+                    bool ok = kernels[k](input.data(), input.size(), base, values);
+                    cases++;
+                    if (ok == expectOk && (!ok || memcmp(values, expected, length) == 0)) agree++;
+                    if (!ok) rejected++;
+                    else translated++;
+                }
+            }
+        }
+    }
+    output << "kernels agree with reference: " << (agree == cases) << endl;
+    output << "rejected every bad run: " << (rejected == cases - translated && translated == 4 * 71 * kernelCount) << endl;
+
+    HTreeFour tree;
+    XArrayList<pair<char, int>> freqList;
+    freqList.add({'a', 5});
+    freqList.add({'b', 3});
+    freqList.add({'c', 2});
+    freqList.add({'d', 1});
+    freqList.add({'e', 1});
+    tree.build(freqList);
+    xMap<char, string> table([](char &key, int size) { return (int)(unsigned char)key % size; });
+    tree.generateCodes(table);
+    string text, code;
+    for (int i = 0; i < 5000; ++i) text += "abcde"[next() % 5];
+    for (char c : text) code += table.get(c);
+    output << "long decode: " << (tree.decode(code) == text) << endl;
+    string broken = code;
+    broken[broken.size() - 3] = '4';
+    output << "digit == order at the end: " << tree.decode(broken) << endl;
+    broken = code;
+    broken[4096] = 'G';
+    output << "bad digit after the first block: " << tree.decode(broken) << endl;
+
+    //! expect ----------------------------------
+    string expect = "kernels agree with reference: 1\n\
+rejected every bad run: 1\n\
+long decode: 1\n\
+digit == order at the end: \\x00\n\
+bad digit after the first block: \\x00\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,90 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman34()
+{
+    string name = "Huffman34";
+    //! data ------------------------------------
+    stringstream output;
+    auto intHash = [](int &key, int size) { return key % size; };
+    SwissMap<int, int> swiss(intHash);
+    xMap<int, int> chained(intHash);
+    IMap<int, int> *maps[2] = {&swiss, &chained};
+
+    //! output ----------------------------------
+    for (IMap<int, int> *map : maps) {
+        for (int i = 0; i < 3000; ++i) map->put(i * 7, i);
+        for (int i = 0; i < 3000; i += 3) map->remove(i * 7);
+        for (int i = 0; i < 3000; i += 6) map->put(i * 7, -i);
+        map->put(14, 100);
+    }
+    bool same = swiss.size() == chained.size();
+    for (int i = 0; i < 3000; ++i) {
+        int key = i * 7;
+        same = same && swiss.containsKey(key) == chained.containsKey(key);
+        if (same && chained.containsKey(key)) same = swiss.get(key) == chained.get(key);
+    }
+    output << "size: " << swiss.size() << ", same as xMap: " << same << endl;
+    output << "capacity power of two: " << ((swiss.getCapacity() & (swiss.getCapacity() - 1)) == 0) << endl;
+    output << "containsKey(8): " << swiss.containsKey(8) << ", containsValue(-6): " << swiss.containsValue(-6) << endl;
+    output << "remove(7, 0): " << swiss.remove(7, 0) << ", remove(7, 1): " << swiss.remove(7, 1)
+           << ", remove(8, 1): " << swiss.remove(8, 1) << endl;
+    try {
+        swiss.get(21);
+    } catch (const KeyNotFound &e) {
+        output << "get(21): " << e.what() << endl;
+    }
+    int keySum = 0, clashSum = 0;
+    for (int key : swiss.keys()) keySum += key;
+    for (int key : chained.keys()) keySum -= key;
+    for (int displaced : swiss.clashes()) clashSum += displaced;
+    output << "keys match xMap: " << (keySum == -7) << ", displaced keys <= size: " << (clashSum <= swiss.size()) << endl;
+
+    SwissMap<int, int> copy(swiss);
+    copy.put(1, 1);
+    output << "copy: " << copy.size() << " vs " << swiss.size() << endl;
+    swiss.clear();
+    output << "after clear: " << swiss.size() << " " << swiss.empty() << " " << swiss.containsKey(14) << endl;
+
+    // a load factor of 1 would fill every slot: it is clamped, misses still end
+    SwissMap<int, int> packed(intHash, 1.0f), sparse(intHash, 0.0f);
+    for (int i = 0; i < 16; ++i) {
+        packed.put(i, i);
+        sparse.put(i, i);
+    }
+    output << "load factor 1: capacity " << packed.getCapacity() << ", containsKey(99): " << packed.containsKey(99)
+           << "; load factor 0: capacity " << sparse.getCapacity() << endl;
+
+    XArrayList<pair<char, int>> freqList;
+    const char *text = "swiss tables probe sixteen control bytes at once";
+    int counts[256] = {0};
+    for (const char *c = text; *c; ++c) counts[(unsigned char)*c]++;
+    for (int c = 0; c < 256; ++c)
+        if (counts[c] > 0) freqList.add({(char)c, counts[c]});
+    HTreeFour tree;
+    tree.build(freqList);
+    auto charHash = [](char &key, int size) { return (int)(unsigned char)key % size; };
+    xMap<char, string> chainedCodes(charHash);
+    SwissMap<char, string> swissCodes(charHash);
+    tree.generateCodes(chainedCodes);
+    tree.generateCodes(swissCodes);
+    bool sameCodes = swissCodes.size() == chainedCodes.size();
+    for (char c : chainedCodes.keys()) sameCodes = sameCodes && swissCodes.get(c) == chainedCodes.get(c);
+    output << "Huffman codes in SwissMap: " << swissCodes.size() << ", same: " << sameCodes << endl;
+
+    //! expect ----------------------------------
+    string expect = "size: 2500, same as xMap: 1\n\
+capacity power of two: 1\n\
+containsKey(8): 0, containsValue(-6): 1\n\
+remove(7, 0): 0, remove(7, 1): 1, remove(8, 1): 0\n\
+get(21): key (21) is not found\n\
+keys match xMap: 1, displaced keys <= size: 1\n\
+copy: 2500 vs 2499\n\
+after clear: 0 1 0\n\
+load factor 1: capacity 32, containsKey(99): 0; load factor 0: capacity 256\n\
+Huffman codes in SwissMap: 16, same: 1\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
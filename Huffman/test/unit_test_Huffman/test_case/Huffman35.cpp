@@ -0,0 +1,81 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman35()
+{
+    string name = "Huffman35";
+    //! data ------------------------------------
+    stringstream output;
+    auto intHash = [](int &key, int size) { return key % size; };
+    xMap<int, int> incremental(intHash);
+    xMap<int, int> allAtOnce(intHash);
+    incremental.setIncrementalRehash(2);
+    unsigned int seed = 7;
+    auto next = [&]() { seed = seed * 1103515245u + 12345u; return (int)(seed >> 8); };
+
+    //! output ----------------------------------
+    int agree = 0, steps = 0, midRehash = 0, copiesOk = 0;
+    for (int i = 0; i < 20000; ++i) {
+        int key = next() % 5000, op = next() % 4;
+        bool same = true;
+        if (op <= 1) {
+            same = incremental.put(key, i) == allAtOnce.put(key, i);
+        } else if (op == 2) {
+            bool present = allAtOnce.containsKey(key);
+            same = incremental.containsKey(key) == present;
+            if (present) same = same && incremental.remove(key) == allAtOnce.remove(key);
+        } else {
+            bool present = allAtOnce.containsKey(key);
+            same = incremental.containsKey(key) == present && (!present || incremental.get(key) == allAtOnce.get(key));
+        }
+        same = same && incremental.size() == allAtOnce.size();
+        if (incremental.rehashing()) {
+            midRehash++;
+            if (midRehash % 97 == 1) {
+                long long sum = 0;
+                for (int k : incremental.keys()) sum += k;
+                for (int k : allAtOnce.keys()) sum -= k;
+                xMap<int, int> copy(incremental);
+                bool copyOk = sum == 0 && copy.size() == allAtOnce.size();
+                for (int k : allAtOnce.keys()) copyOk = copyOk && copy.get(k) == allAtOnce.get(k);
+                if (copyOk) copiesOk++;
+            }
+        }
+        steps++;
+        if (same) agree++;
+    }
+    output << "operations agree: " << agree << "/" << steps << endl;
+    output << "ops during a migration: " << (midRehash > 1000) << ", snapshots ok: " << (copiesOk == (midRehash + 96) / 97) << endl;
+    output << "same capacity: " << (incremental.getCapacity() == allAtOnce.getCapacity()) << endl;
+
+    // pointer keys freed by the map while a migration is in progress
+    auto stringHash = [](string *&key, int size) { return (int)(key->length() % size); };
+    auto stringEqual = [](string *&lhs, string *&rhs) { return *lhs == *rhs; };
+    xMap<string *, int> owned(stringHash, 0.75f, 0, 0, stringEqual, &xMap<string *, int>::freeKey);
+    owned.setIncrementalRehash(3);
+    int grown = 0;
+    for (int i = 0; i < 300 && grown == 0; ++i) {
+        owned.put(new string(i, 'x'), i);
+        if (owned.rehashing()) grown = owned.size();
+    }
+    string probe(5, 'x');
+    string *probeKey = &probe;
+    output << "pointer keys: " << grown << " mid-migration, get(5 x's): " << owned.get(probeKey) << endl;
+    owned.clear();
+    output << "after clear: " << owned.size() << " " << owned.rehashing() << endl;
+
+    incremental.setIncrementalRehash(0);
+    output << "turned off: " << incremental.rehashing() << endl;
+
+    //! expect ----------------------------------
+    string expect = "operations agree: 20000/20000\n\
+ops during a migration: 1, snapshots ok: 1\n\
+same capacity: 1\n\
+pointer keys: 8 mid-migration, get(5 x's): 5\n\
+after clear: 0 0\n\
+turned off: 0\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,93 @@
+#include "../unit_test_Huffman.hpp"
+
+bool UNIT_TEST_Huffman::Huffman36()
+{
+    string name = "Huffman36";
+    //! data ------------------------------------
+    stringstream output;
+    auto intHash = [](int &key, int size) { return key % size; };
+    auto stringHash = [](string &key, int size) { return (int)(std::hash<string>()(key) % size); };
+
+    //! output ----------------------------------
+    // the pool: blocks come back through the free list of their size
+    PoolAllocator pool(4096);
+    void *first = pool.allocate(24);
+    pool.release(first, 20);
+    void *again = pool.allocate(17);
+    void *large = pool.allocate(1000);
+    size_t withLarge = pool.reserved();
+    pool.release(large, 1000);
+    output << "reused: " << (again == first) << ", large slab freed: " << (pool.reserved() < withLarge) << endl;
+    pool.releaseAll();
+    output << "after releaseAll: " << pool.reserved() << endl;
+
+    // an exclusive pool behind a map that grows, shrinks, is cleared and refilled
+    PoolAllocator entries;
+    xMap<int, int> pooled(intHash);
+    xMap<int, int> plain(intHash);
+    pooled.setAllocator(&entries, true);
+    int agree = 0;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 3000; ++i) {
+            pooled.put(i * 7, i);
+            plain.put(i * 7, i);
+        }
+        for (int i = 0; i < 3000; i += 3) {
+            agree += pooled.remove(i * 7) == plain.remove(i * 7);
+        }
+        for (int i = 0; i < 3000; ++i) {
+            agree += pooled.containsKey(i * 7) == plain.containsKey(i * 7);
+        }
+        output << "round " << round << ": size " << pooled.size() << ", capacity " << pooled.getCapacity() << endl;
+        pooled.clear();
+        plain.clear();
+    }
+    output << "agree: " << agree << "/8000, slabs kept after clear: " << (entries.reserved() > 0) << endl;
+
+    // string keys and values: their destructors still run on the bulk release
+    PoolAllocator words;
+    {
+        xMap<string, string> dictionary(stringHash);
+        dictionary.setAllocator(&words, true);
+        dictionary.setIncrementalRehash(2);
+        for (int i = 0; i < 500; ++i) {
+            dictionary.put("key number " + to_string(i), string(40 + i % 7, 'v'));
+        }
+        xMap<string, string> copy(dictionary);
+        output << "strings: " << dictionary.get("key number 123").length() << " " << copy.size() << endl;
+    }
+
+    // a shared pool (not exclusive): maps give blocks back one by one
+    PoolAllocator shared;
+    xMap<int, int> left(intHash), right(intHash);
+    left.setAllocator(&shared);
+    right.setAllocator(&shared);
+    for (int i = 0; i < 200; ++i) {
+        left.put(i, i);
+        right.put(i, -i);
+    }
+    left.clear();
+    output << "shared: " << right.get(150) << " " << right.size() << endl;
+
+    try {
+        right.setAllocator(nullptr);
+        output << "no error" << endl;
+    } catch (std::logic_error &e) {
+        output << "logic_error: " << e.what() << endl;
+    }
+
+    //! expect ----------------------------------
+    string expect = "reused: 1, large slab freed: 1\n\
+after releaseAll: 0\n\
+round 0: size 2000, capacity 4164\n\
+round 1: size 2000, capacity 4164\n\
+agree: 8000/8000, slabs kept after clear: 1\n\
+strings: 44 500\n\
+shared: -150 200\n\
+logic_error: setAllocator: the map is not empty\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,71 @@
+#include "../unit_test_Huffman.hpp"
+#include <atomic>
+#include <thread>
+
+bool UNIT_TEST_Huffman::Huffman37()
+{
+    string name = "Huffman37";
+    //! data ------------------------------------
+    stringstream output;
+    auto intHash = [](int &key, int size) { return key % size; };
+    ConcurrentXMap<int, int> map(intHash, 8);
+
+    //! output ----------------------------------
+    // one writer adds 0, 1, 2, ... in order: every consistent snapshot is a prefix
+    const int added = 6000;
+    atomic<bool> writing(true);
+    thread writer([&]() {
+        for (int i = 0; i < added; ++i) map.put(i, i * 2);
+        writing = false;
+    });
+    int snapshots = 0, prefixes = 0;
+    while (writing || snapshots == 0) {
+        DLinkedList<int> keys = map.keys();
+        int largest = -1;
+        for (int key : keys) largest = (key > largest) ? key : largest;
+        snapshots++;
+        if (largest + 1 == keys.size()) prefixes++;
+    }
+    writer.join();
+    output << "snapshots are prefixes: " << (prefixes == snapshots) << endl;
+    output << "size: " << map.size() << ", get(4321): " << map.get(4321) << endl;
+
+    // four threads: each removes its own odd keys and bumps its even ones
+    thread workers[4];
+    for (int t = 0; t < 4; ++t) {
+        workers[t] = thread([&map, t]() {
+            for (int i = t; i < added; i += 4) {
+                if (i % 2 == 1) map.remove(i);
+                else map.put(i, map.get(i) + 1);
+            }
+        });
+    }
+    for (int t = 0; t < 4; ++t) workers[t].join();
+    int value = 0, correct = 0;
+    for (int i = 0; i < added; ++i) {
+        bool present = map.tryGet(i, value);
+        if (i % 2 == 1 ? !present : present && value == i * 2 + 1) correct++;
+    }
+    output << "after workers: size " << map.size() << ", correct " << correct << "/" << added << endl;
+
+    try {
+        map.get(1);
+        output << "no error" << endl;
+    } catch (KeyNotFound &e) {
+        output << "KeyNotFound: " << e.what() << endl;
+    }
+    map.clear();
+    output << "cleared: " << map.empty() << ", shards: " << map.getShardCount() << endl;
+
+    //! expect ----------------------------------
+    string expect = "snapshots are prefixes: 1\n\
+size: 6000, get(4321): 8642\n\
+after workers: size 3000, correct 6000/6000\n\
+KeyNotFound: key (1) is not found\n\
+cleared: 1, shards: 8\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
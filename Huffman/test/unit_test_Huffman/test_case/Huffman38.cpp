@@ -0,0 +1,86 @@
+#include "../unit_test_Huffman.hpp"
+
+static int hashCalls = 0;
+static int countingHash(string &key, int size)
+{
+    hashCalls++;
+    return xMap<string, int>::stringKeyHash(key, size);
+}
+
+bool UNIT_TEST_Huffman::Huffman38()
+{
+    string name = "Huffman38";
+    //! data ------------------------------------
+    stringstream output;
+    xMap<string, int> stock(&countingHash);
+
+    //! output ----------------------------------
+    // one hash per put, none when the table grows
+    for (int i = 0; i < 1000; ++i) stock.put("sku-" + to_string(i), i);
+    output << "puts: 1000, hash calls: " << hashCalls << ", capacity: " << stock.getCapacity() << endl;
+
+    // get-or-insert: one hash per call, hit or miss
+    hashCalls = 0;
+    int added = 0;
+    for (int i = 990; i < 1010; ++i) {
+        bool inserted;
+        xMap<string, int>::Entry *entry = stock.findOrPut("sku-" + to_string(i), -1, &inserted);
+        if (inserted) added++;
+        entry->getValue() += 1;
+    }
+    output << "findOrPut: added " << added << ", hash calls: " << hashCalls << ", size: " << stock.size() << endl;
+    output << "sku-995: " << stock.get("sku-995") << ", sku-1005: " << stock.get("sku-1005") << endl;
+
+    // string_view probes with a precomputed hash: no string built, no hashCode call
+    hashCalls = 0;
+    const char *line = "sku-42,sku-7,sku-nope";
+    string_view rest(line);
+    int found = 0, sum = 0;
+    while (!rest.empty()) {
+        size_t comma = rest.find(',');
+        string_view sku = rest.substr(0, comma);
+        xMap<string, int>::Entry *entry = stock.find(xMap<string, int>::stringViewHash(sku, INT_MAX), sku);
+        if (entry != nullptr) {
+            found++;
+            sum += entry->getValue();
+        }
+        rest = (comma == string_view::npos) ? string_view() : rest.substr(comma + 1);
+    }
+    string_view fresh("sku-new");
+    stock.findOrPut(xMap<string, int>::stringViewHash(fresh, INT_MAX), fresh, 77);
+    output << "views: found " << found << ", sum " << sum << ", hash calls: " << hashCalls
+           << ", sku-new: " << stock.get("sku-new") << endl;
+
+    // incremental rehash: find still sees entries waiting in the old table
+    xMap<string, int> incremental(&xMap<string, int>::stringKeyHash);
+    incremental.setIncrementalRehash(1);
+    int missing = 0;
+    bool sawMigration = false;
+    for (int i = 0; i < 300; ++i) {
+        incremental.put("item" + to_string(i), i);
+        sawMigration = sawMigration || incremental.rehashing();
+        for (int j = 0; j <= i; j += 37) {
+            xMap<string, int>::Entry *entry = incremental.find("item" + to_string(j));
+            if (entry == nullptr || entry->getValue() != j) missing++;
+        }
+    }
+    output << "incremental: migrations " << sawMigration << ", missing " << missing << endl;
+
+    // the copy keeps the hashes: copying calls hashCode for nothing
+    hashCalls = 0;
+    xMap<string, int> copy(stock);
+    output << "copy: size " << copy.size() << ", hash calls: " << hashCalls << ", sku-7: " << copy.get("sku-7") << endl;
+
+    //! expect ----------------------------------
+    string expect = "puts: 1000, hash calls: 1000, capacity: 1851\n\
+findOrPut: added 10, hash calls: 20, size: 1010\n\
+sku-995: 996, sku-1005: 0\n\
+views: found 2, sum 49, hash calls: 0, sku-new: 77\n\
+incremental: migrations 1, missing 0\n\
+copy: size 1011, hash calls: 0, sku-7: 7\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -0,0 +1,86 @@
+#include "../unit_test_Huffman.hpp"
+
+// what decodeHuffman did before parseText: trim blanks, then "stream >> double"
+static bool streamNumber(const string &text, double &value)
+{
+    string trimmed = text.substr(min(text.find_first_not_of(" \t"), text.length()));
+    stringstream stream(trimmed);
+    value = 0.0;
+    stream >> value;
+    return !stream.fail();
+}
+
+bool UNIT_TEST_Huffman::Huffman39()
+{
+    string name = "Huffman39";
+    //! data ------------------------------------
+    stringstream output;
+    InventoryManager nothing;
+    InvCompressor compressor(&nothing);
+    List1D<InventoryAttribute> attributes;
+    string productName;
+
+    //! output ----------------------------------
+    // whole records: the text back when it parses, "" or "\x00" when not
+    const char *records[] = {
+        "Fan:(power:   \t 7)",      // leading whitespace
+        "Fan:(power: +3.25)",       // '+' sign
+        "Fan:(power: 4.5kg)",       // tail after the number is ignored
+        "Fan:(power: 1e3x)",        // complete exponent, then a tail
+        "Fan:(power: 1e)",          // dangling exponent
+        "Fan:(power: 2E+)",         // dangling signed exponent
+        "Fan:(power: 1e999)",       // overflow
+        "Fan:(power: abc)",         // no number
+        "Fan:(power: 1",            // unclosed attribute
+        ":(power: 1)",              // empty name
+        "Fan:x",                    // text after the name but no attribute
+        "Fan:",                     // name only
+        "Fan:(: 5)",                // empty key: parsing stops, text is kept
+        "Fan",                      // no name delimiter
+        "Fan:(power: \\x00)",       // the error marker itself
+    };
+    for (const char *record : records) {
+        string result = compressor.parseProduct(record, attributes, productName);
+        output << record << " -> '" << result << "' " << attributes << endl;
+    }
+
+    // numbers: the same verdict and value as the stringstream parser
+    const char *numbers[] = {"0", "-0", "  12", "\t-7.5", "+.5", ".5e1", "5.", "1e-5", "1E+2", "3e",
+                             "-", "+", ".", "+-1", "--1", "0x1A", "inf", "nan", "1e-999", "1e999",
+                             "-1e999", "12abc", "1.2.3", "00012", "1e+", "1e-", "e5", " ", ""};
+    int agree = 0, total = 0;
+    for (const char *number : numbers) {
+        double expected = 0.0;
+        bool parsed = streamNumber(number, expected);
+        string result = compressor.parseProduct(string("Fan:(v: ") + number + ")", attributes, productName);
+        bool same = parsed ? (result != "" && attributes.size() == 1 && attributes.get(0).value == expected)
+                           : result == "";
+        if (same) agree++;
+        else output << "differs: '" << number << "'" << endl;
+        total++;
+    }
+    output << "numbers agreeing with stringstream: " << agree << "/" << total << endl;
+
+    //! expect ----------------------------------
+    string expect = "Fan:(power:   \t 7) -> 'Fan:(power:   \t 7)' [power: 7.000000]\n\
+Fan:(power: +3.25) -> 'Fan:(power: +3.25)' [power: 3.250000]\n\
+Fan:(power: 4.5kg) -> 'Fan:(power: 4.5kg)' [power: 4.500000]\n\
+Fan:(power: 1e3x) -> 'Fan:(power: 1e3x)' [power: 1000.000000]\n\
+Fan:(power: 1e) -> '' []\n\
+Fan:(power: 2E+) -> '' []\n\
+Fan:(power: 1e999) -> '' []\n\
+Fan:(power: abc) -> '' []\n\
+Fan:(power: 1 -> '' []\n\
+:(power: 1) -> '' []\n\
+Fan:x -> '' []\n\
+Fan: -> 'Fan:' []\n\
+Fan:(: 5) -> 'Fan:(: 5)' []\n\
+Fan -> '\\x00' []\n\
+Fan:(power: \\x00) -> '\\x00' []\n\
+numbers agreeing with stringstream: 29/29\n";
+
+    //! remove data -----------------------------
+
+    //! result ----------------------------------
+    return printResult(output.str(), expect, name);
+}
@@ -4,6 +4,10 @@
 #include"list/DLinkedList.h"
 #include"list/XArrayList.h"
 #include "app/inventory_compressor.h"
+#include "app/columnar_compressor.h"
+#include "app/tree_order.h"
+#include "hash/SwissMap.h"
+#include "hash/ConcurrentXMap.h"
 #include "unit_test.hpp"
 
 // Macro to simplify test registration
@@ -43,6 +47,48 @@ public:
     REGISTER_TEST(Huffman14);
 
     REGISTER_TEST(Huffman15);
+
+    REGISTER_TEST(Huffman16);
+
+    REGISTER_TEST(Huffman17);
+
+    REGISTER_TEST(Huffman18);
+
+    REGISTER_TEST(Huffman19);
+
+    REGISTER_TEST(Huffman20);
+    REGISTER_TEST(Huffman21);
+    REGISTER_TEST(Huffman22);
+    REGISTER_TEST(Huffman23);
+    REGISTER_TEST(Huffman24);
+    REGISTER_TEST(Huffman25);
+    REGISTER_TEST(Huffman26);
+
+    REGISTER_TEST(Huffman27);
+
+    REGISTER_TEST(Huffman28);
+
+    REGISTER_TEST(Huffman29);
+
+    REGISTER_TEST(Huffman30);
+
+    REGISTER_TEST(Huffman31);
+
+    REGISTER_TEST(Huffman32);
+
+    REGISTER_TEST(Huffman33);
+
+    REGISTER_TEST(Huffman34);
+
+    REGISTER_TEST(Huffman35);
+
+    REGISTER_TEST(Huffman36);
+
+    REGISTER_TEST(Huffman37);
+
+    REGISTER_TEST(Huffman38);
+
+    REGISTER_TEST(Huffman39);
   }
 
 private:
@@ -75,6 +121,35 @@ private:
   bool Huffman14();
 
   bool Huffman15();
+
+  bool Huffman16();
+
+  bool Huffman17();
+
+  bool Huffman18();
+
+  bool Huffman19();
+
+  bool Huffman20();
+  bool Huffman21();
+  bool Huffman22();
+  bool Huffman23();
+  bool Huffman24();
+  bool Huffman25();
+  bool Huffman26();
+  bool Huffman27();
+  bool Huffman28();
+  bool Huffman29();
+  bool Huffman30();
+  bool Huffman31();
+  bool Huffman32();
+  bool Huffman33();
+  bool Huffman34();
+  bool Huffman35();
+  bool Huffman36();
+  bool Huffman37();
+  bool Huffman38();
+  bool Huffman39();
 };
 int charHashFunc(char& key, int tablesize);
 typedef HuffmanTree<2> HTreeTow;